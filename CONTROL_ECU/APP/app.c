@@ -10,16 +10,17 @@
  *                     	   	  Global Variables                                 *
  *******************************************************************************/
 
-uint8 g_receivedPassword[6] = {0}; /*User password input received from HMI ECU*/
+/*User password input received from HMI ECU (extra characters for the terminator special char and the null)*/
+uint8 g_receivedPassword[PASSWORD_MAX_LENGTH + 2] = {0};
 /*
  * A buffer that stores:
  * 1- the received password confirmation.
  * 2- the password retrieved from the EEPROM
  * in any case, the received password is compared with the buffer value.
  * */
-uint8 g_passwordBuffer[6] = {0};
+uint8 g_passwordBuffer[PASSWORD_MAX_LENGTH + 2] = {0};
 uint8 g_wrong_passwords = 0;	/*wrong passwords counter*/
-uint8 g_timer1_tick = 0;		/*timer 1 compare match counter*/
+static APP_LinkStatus g_linkStatus = LINK_OK;	/*state of the exchange in progress with HMI ECU*/
 
 
 /*******************************************************************************
@@ -30,8 +31,16 @@ uint8 g_timer1_tick = 0;		/*timer 1 compare match counter*/
  * Description:
  * A function that receive a password string from the HMI ECU.
  * The password is stored in a given password buffer.
+ * Returns FALSE if the link to HMI ECU broke (g_linkStatus).
  */
-static void APP_receivePassword(uint8 * const a_password);
+static boolean APP_receivePassword(uint8 * const a_password);
+
+/*
+ * Description:
+ * Wait for a byte from HMI ECU, answering the sync bytes on the way.
+ * Returns FALSE if the link to HMI ECU broke (g_linkStatus).
+ */
+static boolean APP_waitForHmi(uint8 a_expected, boolean a_idle);
 
 /*
  * Description:
@@ -63,6 +72,63 @@ static void APP_savePassword(void);
  * */
 static void APP_retrievePassword(void);
 
+/*
+ * Description:
+ * Number of digits of a received password, 0 if it is too short or too long.
+ * */
+static uint8 APP_passwordLength(const uint8 * const a_password);
+
+/*
+ * Description:
+ * Wait for a given number of milliseconds counted by the system tick.
+ * */
+static void APP_waitMs(uint32 a_duration_ms);
+
+/*
+ * Description:
+ * Save the door state in EEMPROM before each phase of the door sequence.
+ * */
+static void APP_saveDoorState(APP_DoorState a_state);
+
+/*
+ * Description:
+ * Save the door state in EEPROM and report the new phase to HMI ECU.
+ * */
+static void APP_reportDoorState(APP_DoorState a_state);
+
+/*
+ * Description:
+ * Part of the travel to the target already covered, in percent.
+ * */
+static uint8 APP_doorTravelled(POSITION_Target a_target);
+
+/*
+ * Description:
+ * Move the door with the motion profile until it reaches the target or the motor stops,
+ * reporting the door position to HMI ECU if a_report is TRUE.
+ * Returns FALSE if the door did not reach the target.
+ * */
+static boolean APP_moveDoor(DcMotor_State a_direction, boolean a_report);
+
+/*
+ * Description:
+ * Close the door, reversing it on an obstacle, and report the last phase of the sequence.
+ * Returns TRUE if the door is closed.
+ * */
+static boolean APP_closeDoor(void);
+
+/*
+ * Description:
+ * What stopped the last move of the door, OBSTACLE_CAUSE_NONE if nothing did.
+ * */
+static APP_ObstacleCause APP_obstacleCause(void);
+
+/*
+ * Description:
+ * Count an obstacle in EEPROM and log its cause and the door position.
+ * */
+static void APP_logObstacle(APP_ObstacleCause a_cause, uint8 a_position);
+
 /*******************************************************************************
  *                     		 Functions Definitions                             *
  *******************************************************************************/
@@ -72,18 +138,80 @@ static void APP_retrievePassword(void);
  * A function that receive a password string from the HMI ECU.
  * The password is stored in a given password buffer.
  */
-static void APP_receivePassword(uint8 * const a_password)
+static boolean APP_receivePassword(uint8 * const a_password)
 {
 
 	/*Acknowledge that receiver (CONTROL ECU) is ready to receive password value */
 	USART_sendByte(USART_RECEIVER_READY_BYTE);
 
-	while( USART_receiveByte() != USART_SENDER_READY_BYTE && USART_receiveByte() != ALARM_COMMAND )
+	/*wait until the sender is (HMI ECU) ready to send the password, the user is typing it*/
+	if(!APP_waitForHmi(USART_SENDER_READY_BYTE, TRUE))
 	{
-		; /*wait until the sender is (HMI ECU) ready to send the password*/
+		return FALSE;
 	}
 
-	USART_receiveString(a_password); /*receive the password*/
+	/*receive the password*/
+	if(!USART_receiveStringFor(a_password, PASSWORD_MAX_LENGTH + 2, LINK_TIMEOUT_MS))
+	{
+		g_linkStatus = LINK_LOST;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Wait for a byte from HMI ECU, other bytes are dropped.
+ * An idle wait (HMI ECU waits for the user) has no time limit and is the healthy state of
+ * the watchdog, any other wait ends with LINK_LOST after LINK_TIMEOUT_MS.
+ * A sync byte sent by HMI ECU after its boot or a lost link is answered at once and ends
+ * the exchange in progress, the repeated sync bytes still coming are dropped.
+ * Returns FALSE if the link to HMI ECU broke (g_linkStatus).
+ */
+static boolean APP_waitForHmi(uint8 a_expected, boolean a_idle)
+{
+	uint8 byte;
+	uint32 start = SYSTICK_getMs();
+	uint32 elapsed;
+
+	while(g_linkStatus == LINK_OK)
+	{
+		if(a_idle)
+		{
+			WDG_checkIn(WDG_TASK_MAIN);
+			if(!USART_tryReceiveByte(&byte))
+			{
+				continue;
+			}
+		}
+		else
+		{
+			elapsed = SYSTICK_getMs() - start;
+			if(elapsed >= LINK_TIMEOUT_MS || !USART_receiveByteFor(&byte, LINK_TIMEOUT_MS - elapsed))
+			{
+				g_linkStatus = LINK_LOST;
+				break;
+			}
+		}
+
+		if(byte == a_expected)
+		{
+			return TRUE;
+		}
+
+		if(byte == LINK_SYNC_BOOT_BYTE || byte == LINK_SYNC_RESUME_BYTE)
+		{
+			USART_sendByte(LINK_SYNC_ACK_BYTE);
+			g_linkStatus = (byte == LINK_SYNC_BOOT_BYTE) ? LINK_HMI_BOOT : LINK_RESYNC;
+
+			while(USART_receiveByteFor(&byte, LINK_DRAIN_MS))
+			{
+				; /*drop the sync bytes sent again before the reply arrived*/
+			}
+		}
+	}
+
+	return FALSE;
 }
 
 /*
@@ -96,23 +224,31 @@ static void APP_receivePassword(uint8 * const a_password)
 static APP_PasswordStatus APP_confirmPassword(const uint8 * const a_password1, const uint8 * const a_password2)
 {
 	uint8 i = 0;
+	uint8 length = APP_passwordLength(a_password1);
 	/*passwords are matching unless otherwise is proved*/
 	APP_PasswordStatus status = MATCHING_PASSWORDS;
 
-	for (i = 0; i < PASSWORD_LENGTH; i++)
+	/*a password of a wrong length never matches, not even an erased one*/
+	if(length == 0 || length != APP_passwordLength(a_password2))
 	{
-		if(g_receivedPassword[i] != g_passwordBuffer[i])
+		status = UNMATCHING_PASSWORDS;
+	}
+
+	for (i = 0; i < length && status == MATCHING_PASSWORDS; i++)
+	{
+		if(a_password1[i] != a_password2[i])
 		{
 			status =  UNMATCHING_PASSWORDS;
-			break;
 		}
 	}
 
 	/*Acknowledge that sender (CONTROL ECU) is ready */
 	USART_sendByte(USART_SENDER_READY_BYTE);
 
-	while( USART_receiveByte() != USART_RECEIVER_READY_BYTE){
-		; /*wait until the receiver (HMI ECU) is ready*/
+	/*wait until the receiver (HMI ECU) is ready*/
+	if(!APP_waitForHmi(USART_RECEIVER_READY_BYTE, FALSE))
+	{
+		return UNMATCHING_PASSWORDS;
 	}
 
 	if(status == MATCHING_PASSWORDS)
@@ -137,8 +273,11 @@ static APP_PasswordStatus APP_confirmPassword(const uint8 * const a_password1, c
 static APP_PasswordStatus APP_newPasswordConfirm(void)
 {
 	/*receive the password and it's confirmation and store it*/
-	APP_receivePassword(g_receivedPassword);	/*the password*/
-	APP_receivePassword(g_passwordBuffer);	/*the password confirmation*/
+	if(!APP_receivePassword(g_receivedPassword) ||	/*the password*/
+	   !APP_receivePassword(g_passwordBuffer))		/*the password confirmation*/
+	{
+		return UNMATCHING_PASSWORDS;
+	}
 
 	/*compare the two passwords*/
 	if(APP_confirmPassword(g_receivedPassword,g_passwordBuffer) == MATCHING_PASSWORDS)
@@ -154,91 +293,401 @@ static APP_PasswordStatus APP_newPasswordConfirm(void)
 
 /*
  * Description:
- * Save the received  password in EEPROM memory.
+ * Save the received  password in EEPROM memory: its length at PASSWORD_BASE_ADDRESS
+ * then its digits.
  * */
 static void APP_savePassword(void){
 	uint8 i = 0;
-	for( i =0; i<PASSWORD_LENGTH; i++){
-		EEPROM_writeByte(PASSWORD_BASE_ADDRESS+i, g_receivedPassword[i]);
+	uint8 length = APP_passwordLength(g_receivedPassword);
+
+	for( i =0; i<length; i++){
+		EEPROM_writeByte(PASSWORD_BASE_ADDRESS + 1 + i, g_receivedPassword[i]);
+		APP_waitMs(EEPROM_WRITE_CYCLE_MS);
 	}
+	EEPROM_writeByte(PASSWORD_BASE_ADDRESS, length);
+	APP_waitMs(EEPROM_WRITE_CYCLE_MS);
 }
 
+/*
+ * Description:
+ * retrieve the password from EEPROM memory and store it in a global buffer.
+ * An erased or corrupted length gives an empty password, that matches nothing.
+ * */
 static void APP_retrievePassword(void){
 	uint8 i = 0;
-	for( i =0; i<PASSWORD_LENGTH; i++){
-		EEPROM_readByte(PASSWORD_BASE_ADDRESS + i, g_passwordBuffer + i);
+	uint8 length = 0;
+
+	EEPROM_readByte(PASSWORD_BASE_ADDRESS, &length);
+	if(length < PASSWORD_MIN_LENGTH || length > PASSWORD_MAX_LENGTH){
+		length = 0;
+	}
+
+	for( i =0; i<length; i++){
+		EEPROM_readByte(PASSWORD_BASE_ADDRESS + 1 + i, g_passwordBuffer + i);
+	}
+	g_passwordBuffer[length] = '\0';
+}
+
+/*
+ * Description:
+ * Number of digits of a received password, 0 if it is too short or too long.
+ * */
+static uint8 APP_passwordLength(const uint8 * const a_password){
+	uint8 length = 0;
+
+	while(length <= PASSWORD_MAX_LENGTH && a_password[length] != '\0'){
+		length++;
+	}
+
+	if(length < PASSWORD_MIN_LENGTH || length > PASSWORD_MAX_LENGTH){
+		return 0;
+	}
+	return length;
+}
+
+/*
+ * Description:
+ * Wait for a given number of milliseconds counted by the system tick.
+ * */
+static void APP_waitMs(uint32 a_duration_ms)
+{
+	uint32 start = SYSTICK_getMs();
+
+	while((SYSTICK_getMs() - start) < a_duration_ms)
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
 	}
 }
 
 /*
  * Description:
  * Sequence of steps that CONTROL_ECU does when opening the door:
- * 1- rotates the motor CW for 15 seconds 	: Opens the Door
- * 2- turn off the motor for 3 seconds		: Hold the Door open
- * 3- rotates the motor ACW for 15 seconds 	: Closes the Door
+ * 1- moves the door open with a soft start and a soft stop
+ * 2- holds the Door open for 3 seconds
+ * 3- moves the door closed with a soft start and a soft stop
+ * A door jammed while opening is not held open, it is closed right away.
+ * Each phase and the door position are reported to HMI ECU as they change.
  * */
-void APP_doorOpenSequence(TIMER_ConfigType * const a_timer1_configPtr)
+void APP_doorOpenSequence(void)
 {
-	/*rotate the motor CW for 15 seconds*/
-	DcMotor_rotate(CW, motor_speed_100, a_timer1_configPtr);
-	TIMER_init(a_timer1_configPtr);	/*initialize and configure timer 1*/
-	while(g_timer1_tick < 2);
-
-	/*turn off the motor for 15 seconds*/
-	DcMotor_off();
-	TIMER_changeCompareValue(TIMER1_ID, TIMER1_COMPARE_VALUE_3SEC);
-	while(g_timer1_tick < 3);
-
-	/*rotate the motor ACW for 15 seconds*/
-	DcMotor_rotate(ACW, motor_speed_100, a_timer1_configPtr);
-	TIMER_changeCompareValue(TIMER1_ID, TIMER1_COMPARE_VALUE_7SEC);
-	while(g_timer1_tick < 5);
-
-	/* turn off the timer and the motor*/
-	TIMER_deInit(TIMER1_ID);
-	DcMotor_off();
-	g_timer1_tick = 0;
+	/*open the door, the motion profile stops the motor at the end of the move*/
+	APP_reportDoorState(DOOR_OPENING);
+	if(APP_moveDoor(CW, TRUE))
+	{
+		/*hold the door open for 3 seconds*/
+		APP_reportDoorState(DOOR_OPEN);
+		APP_waitMs(DOOR_OPEN_TIME_MS);
+	}
+
+	/*close the door, it stays open if obstacles kept it from closing*/
+	APP_closeDoor();
 }
 
 /*
  * Description:
- * A function that changes the password.
- * The function is executed in case of a New password or changing an existing one.
+ * Close the door with the beam sensor armed. An obstacle (the beam is broken, or the motor
+ * stalls or draws too much current against it) releases the motor from the system tick within
+ * OBSTACLE_CONFIRM_SAMPLES ms for the beam and CURRENT_OVERCURRENT_SAMPLES PWM periods or
+ * CURRENT_STALL_TIME_MS for the current. The door is then braked for OBSTACLE_BRAKE_TIME_MS
+ * and starts opening again after one EEPROM write (its state), HMI ECU is told with DOOR_OBSTACLE.
+ * The obstacle is logged once the door is open again.
+ * The reopened door is held open and closed again, after OBSTACLE_MAX_REVERSALS it is left open.
+ * The door is not closed at all if the beam sensor can't be armed.
+ * A reopen move that does not reach the open position (stalled or over-current) leaves the
+ * motor off and ends with DOOR_JAMMED, no more closing attempts are made.
+ * A close that times out without obstacle short of the closed position ends with DOOR_JAMMED too.
+ * The last phase is reported: DOOR_CLOSED, DOOR_HELD_OPEN or DOOR_JAMMED.
+ * Returns TRUE if the door is closed.
  * */
-void APP_changePassword(void)
+static boolean APP_closeDoor(void)
+{
+	APP_ObstacleCause cause;
+	uint8 position;
+	uint8 reversals = 0;
+	boolean closed;
+
+	while(1)
+	{
+		if(!OBSTACLE_arm())
+		{
+			/*no free tick slot for the sampling: no unguarded close*/
+			USART_sendByte(DOOR_PHASE_MARKER | DOOR_HELD_OPEN);
+			return FALSE;
+		}
+		APP_reportDoorState(DOOR_CLOSING);
+		closed = APP_moveDoor(ACW, TRUE);
+		OBSTACLE_disarm();
+
+		cause = APP_obstacleCause();
+		if(cause == OBSTACLE_CAUSE_NONE)
+		{
+			/*DOOR_CLOSED is only saved once the door is known to be closed*/
+			APP_reportDoorState(closed ? DOOR_CLOSED : DOOR_JAMMED);
+			return closed;
+		}
+
+		/*stop the door where it is, then open it again*/
+		position = DOOR_PROGRESS_MAX - (uint8)(((uint16)APP_doorTravelled(POSITION_CLOSED) * DOOR_PROGRESS_MAX) / 100);
+		DcMotor_brake();
+		APP_waitMs(OBSTACLE_BRAKE_TIME_MS);
+		DcMotor_coast();
+
+		USART_sendByte(DOOR_PHASE_MARKER | DOOR_OBSTACLE);
+		APP_reportDoorState(DOOR_OPENING);
+		if(!APP_moveDoor(CW, TRUE))
+		{
+			/*the door is stuck against something, it is not closed on it again*/
+			DcMotor_coast();
+			APP_reportDoorState(DOOR_JAMMED);
+			APP_logObstacle(cause, position);
+			return FALSE;
+		}
+		APP_reportDoorState(DOOR_OPEN);
+
+		APP_logObstacle(cause, position);
+
+		if(++reversals >= OBSTACLE_MAX_REVERSALS)
+		{
+			USART_sendByte(DOOR_PHASE_MARKER | DOOR_HELD_OPEN);
+			return FALSE;
+		}
+		APP_waitMs(DOOR_OPEN_TIME_MS);
+	}
+}
+
+/*
+ * Description:
+ * What stopped the last move of the door, OBSTACLE_CAUSE_NONE if nothing did.
+ * */
+static APP_ObstacleCause APP_obstacleCause(void)
 {
-	while (APP_newPasswordConfirm() == UNMATCHING_PASSWORDS)
+	if(OBSTACLE_isTriggered())
+	{
+		return OBSTACLE_CAUSE_BEAM;
+	}
+
+	switch(CURRENT_getFault())
 	{
-		; /*keep waiting until the two received passwords match*/
+	case CURRENT_OVERCURRENT:
+		return OBSTACLE_CAUSE_OVERCURRENT;
+	case CURRENT_STALL:
+		return OBSTACLE_CAUSE_STALL;
+	default:
+		return OBSTACLE_CAUSE_NONE;
 	}
 }
 
 /*
  * Description:
- * sets the buzzer for 1 minute.
+ * Count an obstacle in EEPROM and log its cause and the door position
+ * in a ring of OBSTACLE_LOG_SIZE entries of two bytes.
  * */
-void APP_alarmSequence(TIMER_ConfigType * const a_timer1_config)
+static void APP_logObstacle(APP_ObstacleCause a_cause, uint8 a_position)
 {
-	/*starts the buzzer*/
-	BUZZER_start();
-	/*configure timer1 to count for a minute*/
-	a_timer1_config->mode_data.ctc_compare_value = TIMER1_COMPARE_VALUE_7SEC;
-	TIMER_init(a_timer1_config);
-	while(g_timer1_tick < 8);
+	uint8 count = 0;
+	uint16 entry;
 
-	BUZZER_stop(); /*stop the buzzer*/
+	EEPROM_readByte(OBSTACLE_COUNT_ADDRESS, &count);
+	if(count == 0xFF)
+	{
+		count = 0;	/*erased cell*/
+	}
+	entry = OBSTACLE_LOG_ADDRESS + (uint16)(count % OBSTACLE_LOG_SIZE) * 2;
+
+	EEPROM_writeByte(entry, a_cause);
+	APP_waitMs(EEPROM_WRITE_CYCLE_MS);
+	EEPROM_writeByte(entry + 1, a_position);
+	APP_waitMs(EEPROM_WRITE_CYCLE_MS);
+	EEPROM_writeByte(OBSTACLE_COUNT_ADDRESS, (count < 0xFE) ? count + 1 : count);
+	APP_waitMs(EEPROM_WRITE_CYCLE_MS);
+}
 
-	/* de-initialize timer 1*/
-	g_timer1_tick = 0;
-	TIMER_deInit(TIMER1_ID);
+/*
+ * Description:
+ * Part of the travel to the target already covered, in percent:
+ * counted by the encoder, else estimated from the distance of the motion profile.
+ * */
+static uint8 APP_doorTravelled(POSITION_Target a_target)
+{
+#if (POSITION_USE_ENCODER == 1)
+	return (uint8)(((uint32)(POSITION_TRAVEL_PULSES - POSITION_getRemaining(a_target)) * 100) / POSITION_TRAVEL_PULSES);
+#elif (POSITION_USE_END_STOPS == 1)
+	uint32 travelled = ((uint32)MOTION_getProgress() * MOTOR_TRAVEL_TIMEOUT_MS) / MOTOR_ROTATION_TIME_MS;
+
+	/*only the end-stop tells the door arrived*/
+	if(POSITION_isAt(a_target))
+	{
+		return 100;
+	}
+	return (travelled < 100) ? (uint8)travelled : 99;
+#else
+	return MOTION_getProgress();
+#endif
 }
 
 /*
- * Description :
- * Callback function  that increments a global variable g_timer1_tick
- */
-void APP_timerTickIncrement(void){
-	g_timer1_tick++;
+ * Description:
+ * Move the door with the motion profile until the motor stops, reporting the door
+ * position to HMI ECU if a_report is TRUE: one byte (0 to DOOR_PROGRESS_MAX) each time it changes by one percent.
+ * With position sensors the move cruises until DOOR_SLOWDOWN_PERCENT of the travel, creeps on
+ * and is halted from the ISR of the sensor that tells the door arrived. MOTOR_TRAVEL_TIMEOUT_MS is only
+ * a limit, the move is stopped if it is not there by then. Without sensors the move lasts MOTOR_ROTATION_TIME_MS.
+ * Returns FALSE if the door did not reach the target: the current monitor stopped the motor
+ * (stalled or over-current) or the move timed out.
+ * */
+static boolean APP_moveDoor(DcMotor_State a_direction, boolean a_report)
+{
+	POSITION_Target target = (a_direction == CW) ? POSITION_OPEN : POSITION_CLOSED;
+	uint8 travelled;
+	uint8 position;
+	uint8 reported_position = 0xFF;
+	boolean moving;
+#if (POSITION_USE_END_STOPS == 1 || POSITION_USE_ENCODER == 1)
+	uint32 start = SYSTICK_getMs();
+	boolean slowed = FALSE;
+#endif
+
+	CURRENT_clearFault();
+	POSITION_arm(target);
+
+	if(POSITION_isAt(target))
+	{
+		POSITION_disarm();
+	}
+	else
+	{
+#if (POSITION_USE_END_STOPS == 1 || POSITION_USE_ENCODER == 1)
+		MOTION_move(a_direction, MOTOR_TRAVEL_TIMEOUT_MS);
+#else
+		MOTION_move(a_direction, MOTOR_ROTATION_TIME_MS);
+#endif
+	}
+
+	do
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+
+		/*the last position is read after the motor stopped*/
+		moving = (MOTION_getState() != MOTION_IDLE);
+		travelled = APP_doorTravelled(target);
+
+#if (POSITION_USE_END_STOPS == 1 || POSITION_USE_ENCODER == 1)
+		if(moving && !slowed && travelled >= DOOR_SLOWDOWN_PERCENT)
+		{
+			MOTION_slowDown();
+			slowed = TRUE;
+		}
+		if(moving && (SYSTICK_getMs() - start) >= MOTOR_TRAVEL_TIMEOUT_MS)
+		{
+			MOTION_stop();
+		}
+#endif
+
+		position = (uint8)(((uint16)travelled * DOOR_PROGRESS_MAX) / 100);
+		if(a_direction == ACW)
+		{
+			position = DOOR_PROGRESS_MAX - position;
+		}
+
+		if(a_report && position != reported_position)
+		{
+			USART_sendByte(position);
+			reported_position = position;
+		}
+	}
+	while(moving);
+
+	POSITION_disarm();
+
+#if (POSITION_USE_END_STOPS == 1 || POSITION_USE_ENCODER == 1)
+	return (CURRENT_getFault() == CURRENT_NO_FAULT && POSITION_isAt(target));
+#else
+	return (CURRENT_getFault() == CURRENT_NO_FAULT);
+#endif
+}
+
+/*
+ * Description:
+ * Save the door state in EEPROM and report the new phase to HMI ECU.
+ * */
+static void APP_reportDoorState(APP_DoorState a_state)
+{
+	APP_saveDoorState(a_state);
+	USART_sendByte(DOOR_PHASE_MARKER | a_state);
+}
+
+/*
+ * Description:
+ * Save the door state in EEMPROM before each phase of the door sequence.
+ * */
+static void APP_saveDoorState(APP_DoorState a_state)
+{
+	EEPROM_writeByte(DOOR_STATE_ADDRESS, a_state);
+	APP_waitMs(EEPROM_WRITE_CYCLE_MS);
+}
+
+/*
+ * Description:
+ * Called once at boot, after the drivers are initialized:
+ * 1- Turns the motor off.
+ * 2- Saves the reset cause in EEPROM and counts watchdog resets.
+ * 3- Closes the door if the reset happened while it was open or moving, like the end of the
+ *    door sequence: guarded by the beam sensor and reported to HMI ECU.
+ * */
+void APP_recoverSafeState(void)
+{
+	uint8 watchdog_resets = 0;
+	uint8 door_state = DOOR_CLOSED;
+
+	DcMotor_coast();
+
+	EEPROM_writeByte(RESET_FLAGS_ADDRESS, WDG_getResetFlags());
+	APP_waitMs(EEPROM_WRITE_CYCLE_MS);
+	if(WDG_getResetCause() == WDG_RESET_WATCHDOG)
+	{
+		EEPROM_readByte(WATCHDOG_RESETS_ADDRESS, &watchdog_resets);
+		EEPROM_writeByte(WATCHDOG_RESETS_ADDRESS, watchdog_resets + 1);
+		APP_waitMs(EEPROM_WRITE_CYCLE_MS);
+	}
+
+	/*the door was left open or half way, bring it back to the closed position*/
+	EEPROM_readByte(DOOR_STATE_ADDRESS, &door_state);
+	if(door_state == DOOR_OPENING || door_state == DOOR_OPEN || door_state == DOOR_CLOSING)
+	{
+		APP_closeDoor();
+	}
+}
+
+/*
+ * Description:
+ * A function that changes the password.
+ * The function is executed in case of a New password or changing an existing one.
+ * */
+void APP_changePassword(void)
+{
+	do
+	{
+		/*HMI ECU restarted meanwhile: it starts its password setup over*/
+		g_linkStatus = LINK_OK;
+		if(APP_newPasswordConfirm() == MATCHING_PASSWORDS)
+		{
+			return;
+		}
+	}
+	while(g_linkStatus == LINK_OK || g_linkStatus == LINK_HMI_BOOT); /*keep waiting until the two received passwords match*/
+}
+
+/*
+ * Description:
+ * sounds the alarm siren for 1 minute.
+ * */
+void APP_alarmSequence(void)
+{
+	/*sounds the siren for a minute, it plays in the background*/
+	BUZZER_play(BUZZER_ALARM);
+	APP_waitMs(ALARM_TIME_MS);
+
+	BUZZER_stop(); /*stop the buzzer*/
 }
 
 /*
@@ -247,8 +696,15 @@ void APP_timerTickIncrement(void){
  * It returns the given command or NO_COMMAND if non is received (wrong pass).
  * */
 APP_Commands APP_receiveCommand(void){
+	uint8 command;
+
 	/*receive password from HMI ECU to perform actions*/
-	APP_receivePassword(g_receivedPassword);
+	g_linkStatus = LINK_OK;
+	if(!APP_receivePassword(g_receivedPassword))
+	{
+		/*HMI ECU sets a new password after its boot*/
+		return (g_linkStatus == LINK_HMI_BOOT) ? CHANGE_PASSWORD_COMMAND : NO_COMMAND;
+	}
 
 	/*get the password form memory and store it in a buffer to be compared with the received one*/
 	APP_retrievePassword();
@@ -256,15 +712,22 @@ APP_Commands APP_receiveCommand(void){
 	{
 		/*reset the counter if a correct password is entered*/
 		g_wrong_passwords = 0;
+		BUZZER_play(BUZZER_SUCCESS);
 
 		/*Acknowledge that receiver (CONTROL ECU) is ready to receive command*/
 		USART_sendByte(USART_RECEIVER_READY_BYTE);
 
-		while( USART_receiveByte() != USART_SENDER_READY_BYTE)
+		/*wait until the sender is (HMI ECU) ready to send the command*/
+		if(!APP_waitForHmi(USART_SENDER_READY_BYTE, FALSE) || !USART_receiveByteFor(&command, LINK_TIMEOUT_MS))
 		{
-			; /*wait until the sender is (HMI ECU) ready to send the password*/
+			return (g_linkStatus == LINK_HMI_BOOT) ? CHANGE_PASSWORD_COMMAND : NO_COMMAND;
 		}
-		return USART_receiveByte();
+		return command;
+	}
+	else if(g_linkStatus != LINK_OK)
+	{
+		/*the result did not reach HMI ECU, the attempt is not counted*/
+		return (g_linkStatus == LINK_HMI_BOOT) ? CHANGE_PASSWORD_COMMAND : NO_COMMAND;
 	}
 	else
 	{
@@ -275,6 +738,7 @@ APP_Commands APP_receiveCommand(void){
 		}
 		else
 		{
+			BUZZER_play(BUZZER_FAILURE);
 			return NO_COMMAND; /*no command is received for HMI ECU*/
 		}
 	}
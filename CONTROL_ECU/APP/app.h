@@ -8,9 +8,15 @@
 #define APP_APP_H_
 
 #include "../MCAL/USART/usart.h"
-#include "../MCAL/Timer/timer.h"
+#include "../MCAL/Timer/systick.h"
+#include "../MCAL/Timer/profiler.h"
+#include "../MCAL/Watchdog/watchdog.h"
 #include "../MCAL/I2C/twi.h"
 #include "../HAL/Motors/DC_Motor/dc_motor.h"
+#include "../HAL/Motors/Motion_Profile/motion_profile.h"
+#include "../HAL/Motors/Current_Monitor/current_monitor.h"
+#include "../HAL/Position/position.h"
+#include "../HAL/Obstacle/obstacle.h"
 #include "../HAL/Buzzer/buzzer.h"
 #include "../HAL/EEPROM/eeprom_24c16.h"
 #include <avr/interrupt.h>
@@ -19,13 +25,38 @@
  *                                Definitions                                  *
  *******************************************************************************/
 
-#define PASSWORD_LENGTH 5
+#define PASSWORD_MIN_LENGTH			4		/*shortest password accepted from HMI ECU*/
+#define PASSWORD_MAX_LENGTH			8		/*longest password accepted from HMI ECU, must match HMI ECU*/
 #define MATCHING_PASSWORD_BYTE		0xFF	/*byte sent to HMI ECU when password is matching*/
 #define UNMATCHING_PASSWORD_BYTE	0x00	/*byte sent to HMI ECU when password not matching*/
 #define MAX_WRONG_PASSWORDS			3		/*Allowed number of wrong passwords before alarm triggers*/
-#define TIMER1_COMPARE_VALUE_7SEC	58594	/*compare value for timer1 to tick every 7.5 seconds*/
-#define TIMER1_COMPARE_VALUE_3SEC	23438	/*compare value for timer1 to tick every 3 seconds*/
-#define PASSWORD_BASE_ADDRESS		0x0200	/*The start address of the password location in EEPROM*/
+#define MOTOR_ROTATION_TIME_MS		15000	/*time taken for the motor to open/close the door at full speed*/
+#define MOTOR_PROFILE				MOTION_S_CURVE	/*shape of the soft start and soft stop of the door*/
+#define MOTOR_ACCEL_TIME_MS			1500	/*soft start from standstill to full speed*/
+#define MOTOR_DECEL_TIME_MS			1500	/*soft stop from full speed to standstill*/
+#define MOTOR_BRAKE_AT_END			TRUE	/*the motor brakes at the end of a move to hold the door*/
+#define MOTOR_CREEP_SPEED			30		/*speed of the end of a move, until the door reaches its end-stop*/
+#define MOTOR_TRAVEL_TIMEOUT_MS		20000	/*a door that did not reach its position sensor by then is stopped*/
+#define DOOR_SLOWDOWN_PERCENT		90		/*part of the travel covered at full speed when a position sensor is fitted*/
+#define DOOR_OPEN_TIME_MS			3000	/*time for which the door is left open*/
+#define OBSTACLE_BRAKE_TIME_MS		100		/*the motor brakes the door before it reverses on an obstacle*/
+#define OBSTACLE_MAX_REVERSALS		3		/*closing attempts given up after, the door is left open*/
+#define ALARM_TIME_MS				60000	/*time for which the buzzer is on*/
+#define PASSWORD_BASE_ADDRESS		0x0200	/*The password in EEPROM: its length then its digits*/
+#define RESET_FLAGS_ADDRESS			0x0300	/*MCUCSR reset flags of the last boot*/
+#define WATCHDOG_RESETS_ADDRESS		0x0301	/*number of resets caused by the watchdog*/
+#define DOOR_STATE_ADDRESS			0x0302	/*last known state of the door (APP_DoorState)*/
+#define OBSTACLE_COUNT_ADDRESS		0x0303	/*number of obstacles that reversed the door*/
+#define OBSTACLE_LOG_ADDRESS		0x0310	/*the last OBSTACLE_LOG_SIZE obstacles: cause then door position*/
+#define OBSTACLE_LOG_SIZE			8
+#define EEPROM_WRITE_CYCLE_MS		10		/*the 24C16 ignores any access during its internal write cycle*/
+#define DOOR_PROGRESS_MAX			100		/*door position reported to HMI ECU: 0 closed, 100 open*/
+#define DOOR_PHASE_MARKER			0x80	/*ORed with an APP_DoorState to report a new phase to HMI ECU*/
+#define LINK_SYNC_BOOT_BYTE			0xA5	/*HMI ECU restarted: the exchange in progress is dropped and a new password follows*/
+#define LINK_SYNC_RESUME_BYTE		0xA6	/*HMI ECU lost the link: the exchange in progress is dropped*/
+#define LINK_SYNC_ACK_BYTE			0x5A	/*reply to a sync byte*/
+#define LINK_TIMEOUT_MS				1000	/*longest wait for HMI ECU inside an exchange*/
+#define LINK_DRAIN_MS				10		/*repeated sync bytes still on the way after the reply are dropped*/
 
 /*******************************************************************************
  *                               Types Declaration                             *
@@ -35,11 +66,36 @@ typedef enum{
 	MATCHING_PASSWORDS, UNMATCHING_PASSWORDS
 }APP_PasswordStatus;
 
+/*
+ * door state kept in EEPROM so it survives a reset (erased cells read as 0xFF: unknown),
+ * DOOR_OBSTACLE and DOOR_HELD_OPEN (the door is left open, last phase of the sequence)
+ * are only reported to HMI ECU, never saved.
+ * DOOR_JAMMED (the door could not be reopened on an obstacle) is saved and ends the
+ * sequence, the door is not moved again by itself, not even after a reset.
+ */
+typedef enum{
+	DOOR_CLOSED, DOOR_OPENING, DOOR_OPEN, DOOR_CLOSING, DOOR_OBSTACLE, DOOR_HELD_OPEN, DOOR_JAMMED
+}APP_DoorState;
+
+/*what stopped the door while it was closing, kept in the obstacle log*/
+typedef enum{
+	OBSTACLE_CAUSE_NONE, OBSTACLE_CAUSE_BEAM, OBSTACLE_CAUSE_OVERCURRENT, OBSTACLE_CAUSE_STALL
+}APP_ObstacleCause;
+
+/*state of the exchange with HMI ECU, anything but LINK_OK ends the exchange in progress*/
+typedef enum{
+	LINK_OK,			/*exchange going on*/
+	LINK_LOST,			/*HMI ECU did not answer within LINK_TIMEOUT_MS*/
+	LINK_RESYNC,		/*HMI ECU lost the link and went back to its main menu*/
+	LINK_HMI_BOOT		/*HMI ECU restarted, it sets a new password first*/
+}APP_LinkStatus;
+
 typedef enum{
 	NO_COMMAND,						/*No command was received from HMI ECU*/
 	OPEN_DOOR_COMMAND = 0x10,		/*Command received from HMI ECU to open the door*/
 	CHANGE_PASSWORD_COMMAND = 0x11,	/*Command received from HMI ECU to change the password*/
-	ALARM_COMMAND = 0x12			/*Command when alarm is to be triggered*/
+	ALARM_COMMAND = 0x12,			/*Command when alarm is to be triggered*/
+	PROFILE_REPORT_COMMAND = 0x13	/*Debug command: send the profiler report (profiling builds)*/
 }APP_Commands;
 
 
@@ -47,21 +103,38 @@ typedef enum{
  *                              Functions Prototypes                           *
  *******************************************************************************/
 
+/*
+ * Description:
+ * Called once at boot, after the drivers are initialized:
+ * 1- Turns the motor off.
+ * 2- Saves the reset cause in EEPROM and counts watchdog resets.
+ * 3- Closes the door if the reset happened while it was open or moving, like the end of the
+ *    door sequence: guarded by the beam sensor and reported to HMI ECU.
+ * */
+void APP_recoverSafeState(void);
+
 /*
  * Description:
  * Function that receives a command from HMI ECU.
- * It returns the given command or NO_COMMAND if non is received (wrong pass).
+ * It returns the given command or NO_COMMAND if non is received (wrong pass or lost link).
+ * CHANGE_PASSWORD_COMMAND is also returned when HMI ECU restarted, it sets a new password at boot.
  * */
 APP_Commands APP_receiveCommand(void);
 
 /*
  * Description:
  * Sequence of steps that CONTROL_ECU does when opening the door:
- * 1- rotates the motor CW for 15 seconds 	: Opens the Door
- * 2- turn off the motor for 3 seconds		: Hold the Door open
- * 3- rotates the motor ACW for 15 seconds 	: Closes the Door
+ * 1- moves the door open with a soft start and a soft stop
+ * 2- holds the Door open for 3 seconds
+ * 3- moves the door closed with a soft start and a soft stop
+ * A door jammed while opening is not held open, it is closed right away.
+ * An obstacle while closing reverses the door: it is opened again and held open
+ * before the next attempt, up to OBSTACLE_MAX_REVERSALS times.
+ * The sequence ends with DOOR_CLOSED, DOOR_HELD_OPEN if the door is left open, or
+ * DOOR_JAMMED if it could not be reopened.
+ * Each phase and the door position are reported to HMI ECU as they change.
  * */
-void APP_doorOpenSequence(TIMER_ConfigType * const a_timer1_config);
+void APP_doorOpenSequence(void);
 
 /*
  * Description:
@@ -72,14 +145,8 @@ void APP_changePassword(void);
 
 /*
  * Description:
- * sets the buzzer for 1 minute.
+ * sounds the alarm siren for 1 minute.
  * */
-void APP_alarmSequence(TIMER_ConfigType * const a_timer1_config);
-
-/*
- * Description :
- * Callback function  that increments a global variable g_timer1_tick
- */
-void APP_timerTickIncrement(void);
+void APP_alarmSequence(void);
 
 #endif /* APP_APP_H_ */
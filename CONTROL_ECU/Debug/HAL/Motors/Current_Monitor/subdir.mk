@@ -0,0 +1,24 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../HAL/Motors/Current_Monitor/current_monitor.c 
+
+OBJS += \
+./HAL/Motors/Current_Monitor/current_monitor.o 
+
+C_DEPS += \
+./HAL/Motors/Current_Monitor/current_monitor.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+HAL/Motors/Current_Monitor/%.o: ../HAL/Motors/Current_Monitor/%.c HAL/Motors/Current_Monitor/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -0,0 +1,24 @@
+################################################################################
+# Automatically-generated file. Do not edit!
+################################################################################
+
+# Add inputs and outputs from these tool invocations to the build variables 
+C_SRCS += \
+../HAL/Motors/Motion_Profile/motion_profile.c 
+
+OBJS += \
+./HAL/Motors/Motion_Profile/motion_profile.o 
+
+C_DEPS += \
+./HAL/Motors/Motion_Profile/motion_profile.d 
+
+
+# Each subdirectory must supply rules for building sources it contributes
+HAL/Motors/Motion_Profile/%.o: ../HAL/Motors/Motion_Profile/%.c HAL/Motors/Motion_Profile/subdir.mk
+	@echo 'Building file: $<'
+	@echo 'Invoking: AVR Compiler'
+	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega32 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+
@@ -4,13 +4,22 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../MCAL/Timer/timer.c 
+../MCAL/Timer/timer.c \
+../MCAL/Timer/timer_manager.c \
+../MCAL/Timer/systick.c \
+../MCAL/Timer/profiler.c 
 
 OBJS += \
-./MCAL/Timer/timer.o 
+./MCAL/Timer/timer.o \
+./MCAL/Timer/timer_manager.o \
+./MCAL/Timer/systick.o \
+./MCAL/Timer/profiler.o 
 
 C_DEPS += \
-./MCAL/Timer/timer.d 
+./MCAL/Timer/timer.d \
+./MCAL/Timer/timer_manager.d \
+./MCAL/Timer/systick.d \
+./MCAL/Timer/profiler.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -23,10 +23,17 @@ SUBDIRS := \
 APP \
 HAL/Buzzer \
 HAL/EEPROM \
+HAL/Motors/Current_Monitor \
 HAL/Motors/DC_Motor \
+HAL/Motors/Motion_Profile \
+HAL/Obstacle \
+HAL/Position \
+MCAL/ADC \
+MCAL/EXTI \
 MCAL/GPIO \
 MCAL/I2C \
 MCAL/Timer \
 MCAL/USART \
+MCAL/Watchdog \
 . \
 
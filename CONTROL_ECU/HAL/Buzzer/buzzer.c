@@ -5,20 +5,312 @@
  *******************************************************************************/
 
 #include "../../MCAL/GPIO/gpio.h"
+#include "../../MCAL/Timer/timer_manager.h"
+#include "../../MCAL/Timer/systick.h"
+#include "../Motors/DC_Motor/dc_motor.h"
 #include "buzzer.h"
+#include <avr/pgmspace.h>
 
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if (DC_MOTOR_PWM_SOURCE == DC_MOTOR_PWM_TIMER1)
+#error "The buzzer on OC1B (PD4) can't be fitted with the timer1 PWM of the motor, its enable pin"
+#endif
+
+/*requests from the application to the tick, besides a BUZZER_Sound*/
+#define BUZZER_NO_REQUEST		0xFE
+#define BUZZER_SILENCE			0xFF
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*same base as the profiler and the encoder: timer1 free running at F_CPU/8*/
+static const TIMER_ConfigType g_buzzerTimerConfig =
+{
+		.timer_id = TIMER1_ID,
+		.mode = OVERFLOW_MODE,
+		.prescaler.timer1 = TIMER1_F_CPU_8,
+		.ocx_pin_behavior = TOGGLE_OCX,
+		.mode_data.ctc_compare_value = 0,
+};
+
+static const BUZZER_Step g_buzzerClick[] PROGMEM =
+{
+		{BUZZER_HALF_PERIOD(4000), BUZZER_HALF_PERIOD(4000), 5}
+};
+
+static const BUZZER_Step g_buzzerSuccess[] PROGMEM =
+{
+		{BUZZER_HALF_PERIOD(1000), BUZZER_HALF_PERIOD(2500), 80},
+		{BUZZER_REST, BUZZER_REST, 30},
+		{BUZZER_HALF_PERIOD(2500), BUZZER_HALF_PERIOD(2500), 60}
+};
+
+static const BUZZER_Step g_buzzerFailure[] PROGMEM =
+{
+		{BUZZER_HALF_PERIOD(300), BUZZER_HALF_PERIOD(300), 200},
+		{BUZZER_REST, BUZZER_REST, 100},
+		{BUZZER_HALF_PERIOD(300), BUZZER_HALF_PERIOD(300), 400}
+};
+
+static const BUZZER_Step g_buzzerAlarm[] PROGMEM =
+{
+		{BUZZER_HALF_PERIOD(600), BUZZER_HALF_PERIOD(1400), 500},
+		{BUZZER_HALF_PERIOD(1400), BUZZER_HALF_PERIOD(600), 500}
+};
+
+static const BUZZER_Step g_buzzerTone[] PROGMEM =
+{
+		{BUZZER_HALF_PERIOD(2000), BUZZER_HALF_PERIOD(2000), 1000}
+};
+
+/*indexed by BUZZER_Sound*/
+static const BUZZER_Sequence g_buzzerSequences[BUZZER_NUM_OF_SOUNDS] PROGMEM =
+{
+		{g_buzzerClick,		sizeof(g_buzzerClick) / sizeof(BUZZER_Step),	FALSE},
+		{g_buzzerSuccess,	sizeof(g_buzzerSuccess) / sizeof(BUZZER_Step),	FALSE},
+		{g_buzzerFailure,	sizeof(g_buzzerFailure) / sizeof(BUZZER_Step),	FALSE},
+		{g_buzzerAlarm,		sizeof(g_buzzerAlarm) / sizeof(BUZZER_Step),	TRUE},
+		{g_buzzerTone,		sizeof(g_buzzerTone) / sizeof(BUZZER_Step),		TRUE}
+};
+
+/*single byte written by the application and taken by the tick, no locking needed*/
+static volatile uint8 g_buzzerRequest = BUZZER_NO_REQUEST;
+static volatile boolean g_buzzerPlaying = FALSE;
+
+/*sequence being played, only used from the tick*/
+static const BUZZER_Step * g_buzzerSteps;
+static uint8 g_buzzerLength;
+static boolean g_buzzerRepeat;
+static uint8 g_buzzerIndex;
+static uint16 g_buzzerStepTime;
+
+/*half period of the glide in 1/256 timer ticks and its change per update*/
+static uint32 g_buzzerHalfPeriodQ8;
+static sint32 g_buzzerGlideQ8;
+
+/*read by the compare ISR*/
+static volatile uint16 g_buzzerHalfPeriod = 0;
+
+/*OC1B is claimed once by BUZZER_init, the tick only turns the channel on and off*/
+static boolean g_buzzerChannelClaimed = FALSE;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*Description:
+ * Called from the compare B ISR: the pin was toggled, the next toggle is half a period later
+ * (half a period from now if the ISR came after that toggle).
+ * */
+static void BUZZER_toggle(void);
+
+/*Description:
+ * Called from the system tick: take the requests and step the sequence.
+ * */
+static void BUZZER_update(void);
+
+/*Description:
+ * Start the current step of the sequence.
+ * */
+static void BUZZER_startStep(void);
+
+/*Description:
+ * Sound a tone of the given half period, or silence the pin if it is BUZZER_REST.
+ * */
+static void BUZZER_output(uint16 a_half_period);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*Description:
+ * Called from the compare B ISR: the pin was toggled, the next toggle is half a period later
+ * (half a period from now if the ISR came after that toggle).
+ * */
+static void BUZZER_toggle(void)
+{
+	TIMER_advanceCompare(TIMER1_CHANNEL_OC1B, g_buzzerHalfPeriod);
+}
+
+/*Description:
+ * Sound a tone of the given half period, or silence the pin if it is BUZZER_REST.
+ * The compare output and its interrupt are only on while a tone sounds so the ISR does
+ * not run in silence. Called from the tick: the channel claimed at init is only switched,
+ * the timer manager is never called here.
+ * */
+static void BUZZER_output(uint16 a_half_period)
+{
+	if(a_half_period == BUZZER_REST)
+	{
+		if(g_buzzerChannelClaimed)
+		{
+			TIMER_disableChannel(TIMER1_CHANNEL_OC1B);
+		}
+		GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+		g_buzzerHalfPeriod = 0;
+		return;
+	}
+
+	if(g_buzzerHalfPeriod == 0)
+	{
+		g_buzzerHalfPeriod = a_half_period;
+		if(g_buzzerChannelClaimed)
+		{
+			TIMER_setupChannel(TIMER1_CHANNEL_OC1B, &g_buzzerTimerConfig);
+			TIMER_scheduleCompare(TIMER1_CHANNEL_OC1B, a_half_period);
+		}
+		else
+		{
+			GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
+		}
+	}
+	else
+	{
+		g_buzzerHalfPeriod = a_half_period;
+	}
+}
+
+/*Description:
+ * Start the current step of the sequence, a glide changes the half period
+ * at each update by a step computed once here.
+ * */
+static void BUZZER_startStep(void)
+{
+	BUZZER_Step step;
+
+	memcpy_P(&step, &g_buzzerSteps[g_buzzerIndex], sizeof(BUZZER_Step));
+
+	g_buzzerStepTime = step.duration_ms;
+	g_buzzerHalfPeriodQ8 = (uint32)step.start_half_period << 8;
+	g_buzzerGlideQ8 = 0;
+
+	if(step.start_half_period != BUZZER_REST && step.end_half_period != step.start_half_period && step.duration_ms > BUZZER_UPDATE_PERIOD_MS)
+	{
+		g_buzzerGlideQ8 = (((sint32)step.end_half_period - (sint32)step.start_half_period) << 8) / (sint32)(step.duration_ms / BUZZER_UPDATE_PERIOD_MS);
+	}
+
+	BUZZER_output(step.start_half_period);
+}
+
+/*Description:
+ * Called from the system tick: take the requests and step the sequence.
+ * */
+static void BUZZER_update(void)
+{
+	uint8 request = g_buzzerRequest;
+
+	if(request != BUZZER_NO_REQUEST)
+	{
+		g_buzzerRequest = BUZZER_NO_REQUEST;
+
+		if(request == BUZZER_SILENCE)
+		{
+			BUZZER_output(BUZZER_REST);
+			g_buzzerPlaying = FALSE;
+			return;
+		}
+
+		g_buzzerSteps = (const BUZZER_Step *)pgm_read_word(&g_buzzerSequences[request].steps);
+		g_buzzerLength = pgm_read_byte(&g_buzzerSequences[request].length);
+		g_buzzerRepeat = pgm_read_byte(&g_buzzerSequences[request].repeat);
+		g_buzzerIndex = 0;
+		g_buzzerPlaying = TRUE;
+		BUZZER_startStep();
+		return;
+	}
+
+	if(!g_buzzerPlaying)
+	{
+		return;
+	}
+
+	if(g_buzzerStepTime > BUZZER_UPDATE_PERIOD_MS)
+	{
+		g_buzzerStepTime -= BUZZER_UPDATE_PERIOD_MS;
+		if(g_buzzerGlideQ8 != 0)
+		{
+			g_buzzerHalfPeriodQ8 += g_buzzerGlideQ8;
+			BUZZER_output((uint16)(g_buzzerHalfPeriodQ8 >> 8));
+		}
+		return;
+	}
+
+	/*next step, the sequence starts over or ends after its last one*/
+	if(++g_buzzerIndex >= g_buzzerLength)
+	{
+		if(!g_buzzerRepeat)
+		{
+			BUZZER_output(BUZZER_REST);
+			g_buzzerPlaying = FALSE;
+			return;
+		}
+		g_buzzerIndex = 0;
+	}
+	BUZZER_startStep();
+}
+
+/*Description:
+ * Setup the buzzer pin, claim OC1B of timer1 and subscribe the sequencer to the system tick.
+ * */
 void BUZZER_init(void)
 {
 	GPIO_setupPinDirection(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT);
 	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+
+	TIMER_subscribe(TIMER1_EVENT_COMPB, BUZZER_toggle, 1);
+
+	/*the channel stays claimed, it is silent until the first tone*/
+	if(TIMER_claimChannel(TIMER_CLIENT_BUZZER, TIMER1_CHANNEL_OC1B, &g_buzzerTimerConfig) == TIMER_CLAIM_OK)
+	{
+		TIMER_disableChannel(TIMER1_CHANNEL_OC1B);
+		g_buzzerChannelClaimed = TRUE;
+	}
+
+	SYSTICK_subscribe(BUZZER_update, BUZZER_UPDATE_PERIOD_MS);
 }
 
+/*Description:
+ * Start playing a sequence in the background, it replaces the one playing
+ * from the next system tick.
+ * */
+void BUZZER_play(BUZZER_Sound a_sound)
+{
+	if(a_sound < BUZZER_NUM_OF_SOUNDS)
+	{
+		g_buzzerRequest = a_sound;
+	}
+}
+
+/*Description:
+ * Sound a steady tone until BUZZER_stop.
+ * */
 void BUZZER_start(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
+	BUZZER_play(BUZZER_TONE);
 }
 
+/*Description:
+ * Silence the buzzer from the next system tick.
+ * */
 void BUZZER_stop(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	g_buzzerRequest = BUZZER_SILENCE;
+}
+
+/*Description:
+ * Return TRUE while a sequence is playing or about to start.
+ * */
+boolean BUZZER_isPlaying(void)
+{
+	uint8 request = g_buzzerRequest;
+
+	if(request == BUZZER_SILENCE)
+	{
+		return FALSE;
+	}
+	return (request != BUZZER_NO_REQUEST || g_buzzerPlaying);
 }
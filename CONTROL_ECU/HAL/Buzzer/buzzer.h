@@ -9,16 +9,77 @@
 
 #include "../../Utils/std_types.h"
 
-#define BUZZER_PORT_ID		PORTD_ID
-#define BUZZER_PIN_ID		PIN2_ID
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The buzzer is driven from OC1B (PD4): timer1 runs free with the base of the profiler
+ * and the encoder, the compare B channel toggles the pin in hardware and its ISR moves
+ * the next match half a period later. PD4 is the enable pin of the timer1 PWM of the motor,
+ * the two can't be built together. If timer1 is already taken with another base at
+ * BUZZER_init the tones fall back to holding the pin high.
+ */
+#define BUZZER_PORT_ID				PORTD_ID
+#define BUZZER_PIN_ID				PIN4_ID
+
+#define BUZZER_TIMER_CLOCK_HZ		(F_CPU / 8UL)
+#define BUZZER_UPDATE_PERIOD_MS		1		/*the sequences are stepped from the system tick*/
+
+/*timer1 ticks of half a period of a tone, the frequencies of the sequences are converted at compile time*/
+#define BUZZER_HALF_PERIOD(hz)		((uint16)(BUZZER_TIMER_CLOCK_HZ / (2UL * (hz))))
+#define BUZZER_REST					0
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*sequences stored in flash, BUZZER_TONE keeps sounding until BUZZER_stop*/
+typedef enum{
+	BUZZER_CLICK, BUZZER_SUCCESS, BUZZER_FAILURE, BUZZER_ALARM, BUZZER_TONE,
+	BUZZER_NUM_OF_SOUNDS
+}BUZZER_Sound;
+
+/*one step of a sequence: a tone gliding from start to end (the same for a steady tone) or a rest*/
+typedef struct{
+	uint16 start_half_period;		/*BUZZER_HALF_PERIOD(hz) or BUZZER_REST*/
+	uint16 end_half_period;
+	uint16 duration_ms;
+}BUZZER_Step;
+
+typedef struct{
+	const BUZZER_Step * steps;
+	uint8 length;
+	boolean repeat;					/*played again until BUZZER_stop*/
+}BUZZER_Sequence;
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
+/*Description:
+ * Setup the buzzer pin, claim OC1B of timer1 and subscribe the sequencer to the system tick.
+ * */
 void BUZZER_init(void);
-void BUZZER_(void);
+
+/*Description:
+ * Start playing a sequence in the background, it replaces the one playing.
+ * */
+void BUZZER_play(BUZZER_Sound a_sound);
+
+/*Description:
+ * Sound a steady tone until BUZZER_stop.
+ * */
+void BUZZER_start(void);
+
+/*Description:
+ * Silence the buzzer.
+ * */
 void BUZZER_stop(void);
 
+/*Description:
+ * Return TRUE while a sequence is playing.
+ * */
+boolean BUZZER_isPlaying(void);
 
 #endif /* BUZZER_H_ */
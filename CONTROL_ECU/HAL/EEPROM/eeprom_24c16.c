@@ -5,13 +5,43 @@
  *******************************************************************************/
 
 #include "../../MCAL/I2C/twi.h"
+#include "../../MCAL/Timer/profiler.h"
 #include "eeprom_24c16.h"
 
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 EEPROM_writeByteTransfer(uint16 u16addr,uint8 u8data);
+static uint8 EEPROM_readByteTransfer(uint16 u16addr,uint8 *u8data);
+
 /*******************************************************************************
  *                     		 Functions Definitions                             *
  *******************************************************************************/
 
 uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data)
+{
+	uint8 status;
+
+	PROF_BEGIN(PROF_ID_EEPROM_WRITE_BYTE);
+	status = EEPROM_writeByteTransfer(u16addr, u8data);
+	PROF_END(PROF_ID_EEPROM_WRITE_BYTE);
+
+	return status;
+}
+
+uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data)
+{
+	uint8 status;
+
+	PROF_BEGIN(PROF_ID_EEPROM_READ_BYTE);
+	status = EEPROM_readByteTransfer(u16addr, u8data);
+	PROF_END(PROF_ID_EEPROM_READ_BYTE);
+
+	return status;
+}
+
+static uint8 EEPROM_writeByteTransfer(uint16 u16addr,uint8 u8data)
 {
 	/* Send the Start Bit */
 	TWI_start();
@@ -48,7 +78,7 @@ uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data)
 	return SUCCESS;
 }
 
-uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data)
+static uint8 EEPROM_readByteTransfer(uint16 u16addr,uint8 *u8data)
 {
 	/* Send the Start Bit */
 	TWI_start();
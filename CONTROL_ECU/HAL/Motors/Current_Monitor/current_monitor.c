@@ -0,0 +1,161 @@
+/******************************************************************************
+ * [FILE NAME]:     current_monitor.c
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Source file for the current monitor of the DC Motor
+ *******************************************************************************/
+
+#include "../../../MCAL/Timer/systick.h"
+#include "current_monitor.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static const ADC_Channel g_currentSequence[] = { CURRENT_ADC_CHANNEL };
+
+static const ADC_ConfigType g_currentAdcConfig =
+{
+		.reference = ADC_AVCC,
+		.prescaler = ADC_F_CPU_64,		/*125 KHz ADC clock, ~104 us per conversion*/
+		.trigger = CURRENT_ADC_TRIGGER,
+		.sequence = g_currentSequence,
+		.sequence_length = sizeof(g_currentSequence) / sizeof(g_currentSequence[0]),
+};
+
+static volatile CURRENT_Fault g_currentFault = CURRENT_NO_FAULT;
+static void (*g_currentFaultCallBack)(void) = NULL_PTR;
+
+/*filtered value in ADC counts multiplied by 2^CURRENT_FILTER_SHIFT*/
+static volatile uint16 g_currentFiltered = 0;
+
+static uint8 g_currentOverSamples = 0;
+static uint16 g_currentStallTime = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*Description:
+ * Called from the system tick: filter the new samples and stop the motor on a fault.
+ * */
+static void CURRENT_monitor(void);
+
+/*Description:
+ * Let the motor coast, keep the fault and notify the application.
+ * */
+static void CURRENT_trip(CURRENT_Fault a_fault);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*Description:
+ * Let the motor coast, keep the fault and notify the application.
+ * */
+static void CURRENT_trip(CURRENT_Fault a_fault){
+	DcMotor_coast();
+	g_currentFault = a_fault;
+
+	if(g_currentFaultCallBack != NULL_PTR){
+		(*g_currentFaultCallBack)();
+	}
+}
+
+/*Description:
+ * Called from the system tick: filter the new samples and stop the motor on a fault.
+ * The samples are always read so the ring never holds old ones, the limits are only
+ * checked while the motor is driven and no fault is pending.
+ * */
+static void CURRENT_monitor(void){
+	ADC_Sample samples[4];
+	DcMotor_Status status;
+	boolean watching;
+	uint8 count;
+	uint8 index;
+
+	DcMotor_getStatus(&status);
+	watching = (status.mode == DC_MOTOR_RUN && g_currentFault == CURRENT_NO_FAULT);
+
+	while((count = ADC_readSamples(samples, sizeof(samples) / sizeof(samples[0]))) != 0){
+		for(index = 0; index < count; index++){
+			if(samples[index].channel != CURRENT_ADC_CHANNEL){
+				continue;
+			}
+
+			g_currentFiltered = g_currentFiltered - (g_currentFiltered >> CURRENT_FILTER_SHIFT) + samples[index].value;
+
+			if(watching && samples[index].value >= CURRENT_MA_TO_COUNTS(CURRENT_OVERCURRENT_MA)){
+				g_currentOverSamples++;
+			}
+			else{
+				g_currentOverSamples = 0;
+			}
+		}
+	}
+
+	if(!watching){
+		g_currentOverSamples = 0;
+		g_currentStallTime = 0;
+		return;
+	}
+
+	if(g_currentOverSamples >= CURRENT_OVERCURRENT_SAMPLES){
+		CURRENT_trip(CURRENT_OVERCURRENT);
+		return;
+	}
+
+	if((g_currentFiltered >> CURRENT_FILTER_SHIFT) >= CURRENT_MA_TO_COUNTS(CURRENT_STALL_MA)){
+		g_currentStallTime += CURRENT_MONITOR_PERIOD_MS;
+		if(g_currentStallTime >= CURRENT_STALL_TIME_MS){
+			CURRENT_trip(CURRENT_STALL);
+		}
+	}
+	else{
+		g_currentStallTime = 0;
+	}
+}
+
+/*Description:
+ * Start the conversions of the current sense channel and subscribe the monitor to the system tick.
+ * The motor must be initialized first, its PWM timer triggers the conversions.
+ * */
+void CURRENT_init(void){
+	ADC_init(&g_currentAdcConfig);
+	SYSTICK_subscribe(CURRENT_monitor, CURRENT_MONITOR_PERIOD_MS);
+}
+
+/*Description:
+ * Function called from the system tick when a fault stops the motor,
+ * e.g. to cancel the move that was driving it.
+ * */
+void CURRENT_setFaultCallBack(void (*a_ptr)(void)){
+	g_currentFaultCallBack = a_ptr;
+}
+
+/*Description:
+ * Return the fault that stopped the motor, kept until CURRENT_clearFault.
+ * */
+CURRENT_Fault CURRENT_getFault(void){
+	return g_currentFault;
+}
+
+/*Description:
+ * Forget the last fault and watch the motor again.
+ * */
+void CURRENT_clearFault(void){
+	g_currentFault = CURRENT_NO_FAULT;
+}
+
+/*Description:
+ * Return the filtered motor current in mA,
+ * read again if the tick changed it during the copy.
+ * */
+uint16 CURRENT_getMilliamps(void){
+	uint16 filtered;
+
+	do{
+		filtered = g_currentFiltered;
+	}while(filtered != g_currentFiltered);
+
+	return CURRENT_COUNTS_TO_MA(filtered >> CURRENT_FILTER_SHIFT);
+}
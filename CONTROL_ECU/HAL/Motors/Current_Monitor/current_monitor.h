@@ -0,0 +1,87 @@
+/******************************************************************************
+ * [FILE NAME]:     current_monitor.h
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Header file for the current monitor of the DC Motor
+ *******************************************************************************/
+
+#ifndef CURRENT_MONITOR_H_
+#define CURRENT_MONITOR_H_
+
+#include "../../../MCAL/ADC/adc.h"
+#include "../DC_Motor/dc_motor.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*the motor current flows through a shunt resistor read on PA0 against AVCC*/
+#define CURRENT_ADC_CHANNEL			ADC_CHANNEL_0
+#define CURRENT_REFERENCE_MV		5000
+#define CURRENT_SHUNT_MILLIOHM		500
+
+/*
+ * One conversion at the start of each PWM period of the motor (~2 ms on timer0, 1 ms on timer1),
+ * the samples are checked from the system tick every CURRENT_MONITOR_PERIOD_MS.
+ */
+#if (DC_MOTOR_PWM_SOURCE == DC_MOTOR_PWM_TIMER1)
+#define CURRENT_ADC_TRIGGER			ADC_TIMER1_OVERFLOW
+#else
+#define CURRENT_ADC_TRIGGER			ADC_TIMER0_OVERFLOW
+#endif
+#define CURRENT_MONITOR_PERIOD_MS	1
+
+/*
+ * Over-current: CURRENT_OVERCURRENT_SAMPLES samples in a row above the limit,
+ * the motor is stopped within ~5 ms.
+ * Stall: the filtered current stays above the stall limit for CURRENT_STALL_TIME_MS,
+ * longer than the inrush of a soft start.
+ */
+#define CURRENT_OVERCURRENT_MA		2500
+#define CURRENT_OVERCURRENT_SAMPLES	2
+#define CURRENT_STALL_MA			1500
+#define CURRENT_STALL_TIME_MS		100
+#define CURRENT_FILTER_SHIFT		2		/*the filter follows 1/4 of the difference at each sample*/
+
+#define CURRENT_MA_TO_COUNTS(ma)	((uint16)(((uint32)(ma) * CURRENT_SHUNT_MILLIOHM * (ADC_MAX_VALUE + 1)) / (1000UL * CURRENT_REFERENCE_MV)))
+#define CURRENT_COUNTS_TO_MA(counts)	((uint16)(((uint32)(counts) * 1000UL * CURRENT_REFERENCE_MV) / ((uint32)CURRENT_SHUNT_MILLIOHM * (ADC_MAX_VALUE + 1))))
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	CURRENT_NO_FAULT, CURRENT_OVERCURRENT, CURRENT_STALL
+}CURRENT_Fault;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*Description:
+ * Start the conversions of the current sense channel and subscribe the monitor to the system tick.
+ * The motor must be initialized first, its PWM timer triggers the conversions.
+ * */
+void CURRENT_init(void);
+
+/*Description:
+ * Function called from the system tick when a fault stops the motor,
+ * e.g. to cancel the move that was driving it.
+ * */
+void CURRENT_setFaultCallBack(void (*a_ptr)(void));
+
+/*Description:
+ * Return the fault that stopped the motor, kept until CURRENT_clearFault.
+ * */
+CURRENT_Fault CURRENT_getFault(void);
+
+/*Description:
+ * Forget the last fault and watch the motor again.
+ * */
+void CURRENT_clearFault(void);
+
+/*Description:
+ * Return the filtered motor current in mA.
+ * */
+uint16 CURRENT_getMilliamps(void);
+
+#endif /* CURRENT_MONITOR_H_ */
@@ -5,13 +5,92 @@
  *******************************************************************************/
 
 #include "../../../MCAL/GPIO/gpio.h"
-#include "../../../MCAL/Timer/timer.h"
+#include "../../../MCAL/Timer/timer_manager.h"
 #include "dc_motor.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+#if (DC_MOTOR_PWM_SOURCE == DC_MOTOR_PWM_TIMER1)
+
+/*timer1 drives the enable pin (OC1B) of the motor*/
+static const TIMER_ConfigType g_motorPwmConfig =
+{
+		.timer_id = TIMER1_ID,
+		.prescaler.timer1 = TIMER1_F_CPU_1,
+		.mode = PWM_PHASE_CORRECT_MODE,
+		.ocx_pin_behavior = CLEAR_OCX,
+		.timer1_pwm_pin_select = PIN_OC1B,
+		.timer1_pwm_top = DC_MOTOR_TIMER1_PWM_TOP,
+		.mode_data.pwm_duty_cycle = motor_speed_0,
+};
+
+#define DC_MOTOR_PWM_CHANNEL	TIMER1_CHANNEL_OC1B
+
+/*compare value of every speed percentage, computed by the compiler*/
+static const uint16 g_motorDutyTable[] PROGMEM = { TIMER_DUTY_PERCENT_TABLE(DC_MOTOR_TIMER1_PWM_TOP) };
+#define DC_MOTOR_DUTY_COUNT(speed)	pgm_read_word(&g_motorDutyTable[(speed)])
+
+#else
+
+/*timer0 drives the enable pin (OC0) of the motor, the motor is its only owner*/
+static const TIMER_ConfigType g_motorPwmConfig =
+{
+		.timer_id = TIMER0_ID,
+		.prescaler.timer0 = TIMER0_F_CPU_64,
+		.mode = PWM_MODE,
+		.ocx_pin_behavior = CLEAR_OCX,
+		.mode_data.pwm_duty_cycle = motor_speed_0,
+};
+
+#define DC_MOTOR_PWM_CHANNEL	TIMER0_CHANNEL_OC0
+
+/*compare value of every speed percentage, computed by the compiler*/
+static const uint8 g_motorDutyTable[] PROGMEM = { TIMER_DUTY_PERCENT_TABLE(TIMER0_MAX_COUNT) };
+#define DC_MOTOR_DUTY_COUNT(speed)	pgm_read_byte(&g_motorDutyTable[(speed)])
+
+#endif
+
+/*mode, direction and speed are updated together from the tick and read by the application*/
+static volatile DcMotor_Mode g_motorMode = DC_MOTOR_COAST;
+static volatile DcMotor_State g_motorDirection = CW;
+static volatile uint8 g_motorSpeed = motor_speed_0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*Description:
+ * Write the levels of the two inputs of the bridge.
+ * */
+static void DcMotor_writeInputs(uint8 a_in1, uint8 a_in2);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*Description:
+ * Write the levels of the two inputs of the bridge, in a single port write when
+ * they share a port so the bridge never sees a mix of the old and new directions.
+ * */
+static void DcMotor_writeInputs(uint8 a_in1, uint8 a_in2){
+#if (DC_MOTOR_IN1_PORT_ID == DC_MOTOR_IN2_PORT_ID)
+	GPIO_writePortMasked(DC_MOTOR_IN1_PORT_ID,
+			(1 << DC_MOTOR_IN1_PIN_ID) | (1 << DC_MOTOR_IN2_PIN_ID),
+			(a_in1 << DC_MOTOR_IN1_PIN_ID) | (a_in2 << DC_MOTOR_IN2_PIN_ID));
+#else
+	GPIO_writePin(DC_MOTOR_IN1_PORT_ID, DC_MOTOR_IN1_PIN_ID, a_in1);
+	GPIO_writePin(DC_MOTOR_IN2_PORT_ID, DC_MOTOR_IN2_PIN_ID, a_in2);
+#endif
+}
 
 /*Description:
  * Function to Initialize the motor:
  * 1. Setup the direction for the two motor pins.
- * 2. Stop at the DC-Motor at the beginning
+ * 2. Claim the PWM channel of the selected timer once.
+ * 3. Let the DC-Motor coast at the beginning
  * */
 void DcMotor_init(){
 
@@ -20,36 +99,74 @@ void DcMotor_init(){
 	GPIO_setupPinDirection(DC_MOTOR_IN1_PORT_ID, DC_MOTOR_IN1_PIN_ID, PIN_OUTPUT);
 	GPIO_setupPinDirection(DC_MOTOR_IN2_PORT_ID, DC_MOTOR_IN2_PIN_ID, PIN_OUTPUT);
 
+	/*start the PWM signal on the enable pin, speed is changed later by updating the duty cycle only*/
+	TIMER_claimChannel(TIMER_CLIENT_MOTOR, DC_MOTOR_PWM_CHANNEL, &g_motorPwmConfig);
+
 	/*Initially the motor is off */
-	 DcMotor_off();
+	DcMotor_coast();
 }
 
 /*Description:
- * Rotate the DC Motor CW/ or A-CW or stop the motor.
- * Set the required duty cycle via PWM driver according to speed value.
+ * Rotate the DC Motor CW/ or A-CW.
+ * Set the required duty cycle according to speed value (percentage),
+ * the compare value is read from a table in flash.
+ * Only what changed is written: the compare register for the speed
+ * and the port of the two inputs for the direction.
  * */
-void DcMotor_rotate(DcMotor_State state, uint8 speed, TIMER_ConfigType * a_timer0_configPtr){
-	/*configure timer0 duty cycle*/
-	a_timer0_configPtr->mode_data.pwm_duty_cycle = speed; /*speed in percentage*/
-	TIMER_changeDutyCycle(a_timer0_configPtr);
-	TIMER_init(&a_timer0_configPtr);
-
-	switch (state){
-	case CW:
-		GPIO_writePin(DC_MOTOR_IN1_PORT_ID, DC_MOTOR_IN1_PIN_ID, LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_IN2_PORT_ID, DC_MOTOR_IN2_PIN_ID, LOGIC_HIGH);
-		break;
-	case ACW:
-		GPIO_writePin(DC_MOTOR_IN1_PORT_ID, DC_MOTOR_IN1_PIN_ID, LOGIC_HIGH);
-		GPIO_writePin(DC_MOTOR_IN2_PORT_ID, DC_MOTOR_IN2_PIN_ID, LOGIC_LOW);
-		break;
+void DcMotor_rotate(DcMotor_State state, uint8 speed){
+	if(speed > motor_speed_100){
+		speed = motor_speed_100;
+	}
+
+	/*update the duty cycle with a single compare register write, the timer itself keeps running*/
+	if(g_motorMode != DC_MOTOR_RUN || speed != g_motorSpeed){
+		TIMER_changeDutyCount(DC_MOTOR_PWM_CHANNEL, DC_MOTOR_DUTY_COUNT(speed));
+		g_motorSpeed = speed;
+	}
+
+	if(g_motorMode != DC_MOTOR_RUN || state != g_motorDirection){
+		switch (state){
+		case CW:
+			DcMotor_writeInputs(LOGIC_LOW, LOGIC_HIGH);
+			break;
+		case ACW:
+			DcMotor_writeInputs(LOGIC_HIGH, LOGIC_LOW);
+			break;
+		}
+		g_motorDirection = state;
 	}
+
+	g_motorMode = DC_MOTOR_RUN;
+}
+
+/*Description:
+ * Stop the motor actively: both inputs high with the enable pin fully on.
+ * */
+void DcMotor_brake(void){
+	DcMotor_writeInputs(LOGIC_HIGH, LOGIC_HIGH);
+	TIMER_changeDutyCount(DC_MOTOR_PWM_CHANNEL, DC_MOTOR_DUTY_COUNT(motor_speed_100));
+	g_motorSpeed = motor_speed_0;
+	g_motorMode = DC_MOTOR_BRAKE;
+}
+
+/*Description:
+ * Stop driving the motor: enable pin and both inputs low, the motor slows down freely.
+ * */
+void DcMotor_coast(void){
+	TIMER_changeDutyCount(DC_MOTOR_PWM_CHANNEL, DC_MOTOR_DUTY_COUNT(motor_speed_0));
+	DcMotor_writeInputs(LOGIC_LOW, LOGIC_LOW);
+	g_motorSpeed = motor_speed_0;
+	g_motorMode = DC_MOTOR_COAST;
 }
 
 /*Description:
- * Function that turns off the Dc Motor
+ * Copy the current mode, direction and speed of the motor,
+ * read again if the tick changed them during the copy.
  * */
-void DcMotor_off(void){
-	GPIO_writePin(DC_MOTOR_IN1_PORT_ID, DC_MOTOR_IN1_PIN_ID, LOGIC_LOW);
-	GPIO_writePin(DC_MOTOR_IN2_PORT_ID, DC_MOTOR_IN2_PIN_ID, LOGIC_LOW);
+void DcMotor_getStatus(DcMotor_Status * a_status){
+	do{
+		a_status->mode = g_motorMode;
+		a_status->direction = g_motorDirection;
+		a_status->speed = g_motorSpeed;
+	}while(a_status->mode != g_motorMode || a_status->direction != g_motorDirection || a_status->speed != g_motorSpeed);
 }
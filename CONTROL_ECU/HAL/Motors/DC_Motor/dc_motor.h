@@ -19,8 +19,27 @@
 #define DC_MOTOR_IN2_PORT_ID	PORTB_ID
 #define DC_MOTOR_IN2_PIN_ID		PIN1_ID
 
+/*
+ * PWM source of the enable pin:
+ * TIMER0: 8-bit fast PWM on OC0 (PB3), ~490 Hz, 255 steps.
+ * TIMER1: 16-bit phase correct PWM on OC1B (PD4), 1 kHz, 4000 steps.
+ * Timer1 also runs free for the profiler, the encoder (ICP1) and the buzzer (OC1B on PD4):
+ * the TIMER1 source can't be built with the encoder or the buzzer, nor run with the profiler.
+ */
+#define DC_MOTOR_PWM_TIMER0		0
+#define DC_MOTOR_PWM_TIMER1		1
+#define DC_MOTOR_PWM_SOURCE		DC_MOTOR_PWM_TIMER0
+
+/*F_CPU / (2 * TOP) with no pre-scaling*/
+#define DC_MOTOR_TIMER1_PWM_TOP	4000
+
+#if (DC_MOTOR_PWM_SOURCE == DC_MOTOR_PWM_TIMER1)
+#define DC_MOTOR_EN_PORT_ID 	PORTD_ID
+#define DC_MOTOR_EN_PIN_ID 		PIN4_ID
+#else
 #define DC_MOTOR_EN_PORT_ID 	PORTB_ID
 #define DC_MOTOR_EN_PIN_ID 		PIN3_ID
+#endif
 
  enum{
 	motor_speed_0 	= 0,
@@ -38,28 +57,56 @@ typedef enum{
 	CW, ACW
 }DcMotor_State;
 
+/*
+ * COAST: enable pin low, the bridge lets the motor spin freely.
+ * BRAKE: both inputs high with the bridge enabled, the windings are shorted.
+ * RUN: one input high, the motor rotates at the duty cycle of the enable pin.
+ */
+typedef enum{
+	DC_MOTOR_COAST, DC_MOTOR_BRAKE, DC_MOTOR_RUN
+}DcMotor_Mode;
+
+typedef struct{
+	DcMotor_Mode mode;
+	DcMotor_State direction;	/*last direction of rotation*/
+	uint8 speed;				/*percentage, 0 unless the motor runs*/
+}DcMotor_Status;
+
 
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
 
-/*Description:
- * Function that turns off the Dc Motor
- * */
-void DcMotor_off(void);
-
 /*Description:
  * Function to Initialize the motor:
  * 1. Setup the direction for the two motor pins.
- * 2. Stop at the DC-Motor at the beginning
+ * 2. Claim the PWM channel of the selected timer once.
+ * 3. Let the DC-Motor coast at the beginning
  * */
 void DcMotor_init();
 
 /*Description:
- * Rotate the DC Motor CW/ or A-CW or stop the motor.
- * Set the required duty cycle via PWM driver according to speed value.
+ * Rotate the DC Motor CW/ or A-CW.
+ * Set the required duty cycle according to speed value (percentage),
+ * the compare value is read from a table in flash.
+ * Only what changed is written: the compare register for the speed
+ * and the port of the two inputs for the direction.
+ * */
+void DcMotor_rotate(DcMotor_State state, uint8 speed);
+
+/*Description:
+ * Stop the motor actively: both inputs high with the enable pin fully on.
  * */
-void DcMotor_rotate(DcMotor_State state, uint8 speed, TIMER_ConfigType * a_timer0_configPtr);
+void DcMotor_brake(void);
 
+/*Description:
+ * Stop driving the motor: enable pin and both inputs low, the motor slows down freely.
+ * */
+void DcMotor_coast(void);
+
+/*Description:
+ * Copy the current mode, direction and speed of the motor.
+ * */
+void DcMotor_getStatus(DcMotor_Status * a_status);
 
 #endif /* DC_MOTOR_H_ */
@@ -0,0 +1,288 @@
+/******************************************************************************
+ * [FILE NAME]:     motion_profile.c
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Source file for the motion profiles of the DC Motor
+ *******************************************************************************/
+
+#include "../../../MCAL/Timer/systick.h"
+#include "motion_profile.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static MOTION_ConfigType g_motionConfig;
+
+/*the phase is written last by MOTION_move, the tick ignores the other variables while it is idle*/
+static volatile MOTION_State g_motionState = MOTION_IDLE;
+static volatile boolean g_motionStopRequest = FALSE;
+static volatile boolean g_motionSlowRequest = FALSE;
+static boolean g_motionStopped = FALSE;		/*the move was cut short by MOTION_stop*/
+static volatile uint8 g_motionProgress = 0;
+
+static DcMotor_State g_motionDirection;
+static uint32 g_motionAccelTime;
+static uint32 g_motionCruiseTime;
+static uint32 g_motionDecelTime;
+
+/*time spent in the current phase*/
+static uint32 g_motionPhaseElapsed;
+
+/*ramp fraction of the cruise speed now, at the start and at the end of the deceleration*/
+static uint16 g_motionFraction;
+static uint16 g_motionDecelFrom;
+static uint16 g_motionDecelTo;
+static uint16 g_motionCreepFraction;
+
+/*distances in ms at the cruise speed multiplied by MOTION_RAMP_SCALE*/
+static uint32 g_motionDistance;
+static uint32 g_motionTarget;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*Description:
+ * Speed fraction along a ramp at a_position (0 to MOTION_RAMP_SCALE) of its length.
+ * */
+static uint16 MOTION_ramp(uint16 a_position);
+
+/*Description:
+ * Called from the system tick: advance the phase of the move and update the duty cycle.
+ * */
+static void MOTION_update(void);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*Description:
+ * Speed fraction along a ramp at a_position (0 to MOTION_RAMP_SCALE) of its length.
+ * Both shapes cover half of the cruise distance of the ramp time, the S-curve is 3x^2 - 2x^3.
+ * */
+static uint16 MOTION_ramp(uint16 a_position){
+	if(g_motionConfig.profile == MOTION_S_CURVE){
+		return (uint16)(((uint32)a_position * a_position * (3 * MOTION_RAMP_SCALE - 2 * a_position))
+				/ ((uint32)MOTION_RAMP_SCALE * MOTION_RAMP_SCALE));
+	}
+	return a_position;
+}
+
+/*Description:
+ * Called from the system tick: advance the phase of the move and update the duty cycle.
+ * A phase that ends during the period hands its remaining time over to the next one.
+ * */
+static void MOTION_update(void){
+	if(g_motionState == MOTION_IDLE){
+		return;
+	}
+
+	g_motionPhaseElapsed += MOTION_UPDATE_PERIOD_MS;
+
+	/*a soft stop ramps down from the speed reached so far, to standstill or to the creep speed*/
+	if(g_motionStopRequest){
+		g_motionStopRequest = FALSE;
+		g_motionSlowRequest = FALSE;
+		if(g_motionState != MOTION_DECELERATING || g_motionDecelTo != 0){
+			g_motionState = MOTION_DECELERATING;
+			g_motionStopped = TRUE;
+			g_motionDecelFrom = g_motionFraction;
+			g_motionDecelTo = 0;
+			g_motionPhaseElapsed = MOTION_UPDATE_PERIOD_MS;
+		}
+	}
+	else if(g_motionSlowRequest){
+		g_motionSlowRequest = FALSE;
+		if(g_motionState == MOTION_ACCELERATING || g_motionState == MOTION_CRUISING){
+			g_motionState = MOTION_DECELERATING;
+			g_motionDecelFrom = g_motionFraction;
+			g_motionDecelTo = (g_motionCreepFraction < g_motionFraction) ? g_motionCreepFraction : g_motionFraction;
+			g_motionPhaseElapsed = MOTION_UPDATE_PERIOD_MS;
+		}
+	}
+
+	if(g_motionState == MOTION_ACCELERATING && g_motionPhaseElapsed >= g_motionAccelTime){
+		g_motionPhaseElapsed -= g_motionAccelTime;
+		g_motionState = MOTION_CRUISING;
+	}
+	if(g_motionState == MOTION_CRUISING && g_motionPhaseElapsed >= g_motionCruiseTime){
+		g_motionPhaseElapsed -= g_motionCruiseTime;
+		g_motionDecelFrom = MOTION_RAMP_SCALE;
+		g_motionDecelTo = 0;
+		g_motionState = MOTION_DECELERATING;
+	}
+	if(g_motionState == MOTION_DECELERATING && g_motionPhaseElapsed >= g_motionDecelTime && g_motionDecelTo != 0){
+		g_motionState = MOTION_CREEPING;
+	}
+	else if(g_motionState == MOTION_DECELERATING && g_motionPhaseElapsed >= g_motionDecelTime){
+		if(g_motionConfig.brake_at_end){
+			DcMotor_brake();
+		}
+		else{
+			DcMotor_coast();
+		}
+		g_motionFraction = 0;
+
+		/*the rectangle sums of the two ramps cancel out, a complete move covers its distance*/
+		if(!g_motionStopped){
+			g_motionProgress = 100;
+		}
+		g_motionState = MOTION_IDLE;
+		return;
+	}
+
+	switch(g_motionState){
+	case MOTION_ACCELERATING:
+		g_motionFraction = MOTION_ramp((uint16)((g_motionPhaseElapsed * MOTION_RAMP_SCALE) / g_motionAccelTime));
+		break;
+	case MOTION_DECELERATING:
+		g_motionFraction = g_motionDecelTo + (uint16)(((uint32)(g_motionDecelFrom - g_motionDecelTo) *
+				MOTION_ramp((uint16)(MOTION_RAMP_SCALE - (g_motionPhaseElapsed * MOTION_RAMP_SCALE) / g_motionDecelTime)))
+				/ MOTION_RAMP_SCALE);
+		break;
+	case MOTION_CREEPING:
+		g_motionFraction = g_motionDecelTo;
+		break;
+	default:
+		g_motionFraction = MOTION_RAMP_SCALE;
+		break;
+	}
+
+	/*only the compare register changes while the motor keeps its direction*/
+	DcMotor_rotate(g_motionDirection, (uint8)(((uint16)g_motionConfig.cruise_speed * g_motionFraction) / MOTION_RAMP_SCALE));
+
+	g_motionDistance += (uint32)g_motionFraction * MOTION_UPDATE_PERIOD_MS;
+	if(g_motionDistance >= g_motionTarget){
+		g_motionProgress = 100;
+	}
+	else{
+		g_motionProgress = (uint8)((g_motionDistance * 100) / g_motionTarget);
+	}
+}
+
+/*Description:
+ * Keep the profile configuration and subscribe the speed update to the system tick.
+ * The motor must be initialized first.
+ * */
+void MOTION_init(const MOTION_ConfigType * a_config){
+	g_motionConfig = *a_config;
+	if(g_motionConfig.cruise_speed > motor_speed_100){
+		g_motionConfig.cruise_speed = motor_speed_100;
+	}
+
+	if(g_motionConfig.creep_speed >= g_motionConfig.cruise_speed){
+		g_motionCreepFraction = MOTION_RAMP_SCALE;
+	}
+	else{
+		g_motionCreepFraction = ((uint16)g_motionConfig.creep_speed * MOTION_RAMP_SCALE) / g_motionConfig.cruise_speed;
+	}
+
+	SYSTICK_subscribe(MOTION_update, MOTION_UPDATE_PERIOD_MS);
+}
+
+/*Description:
+ * Start a move without blocking: ramp up, cruise then ramp down to standstill.
+ * Each ramp covers half the distance of the same time at the cruise speed, so the cruise
+ * is shortened by half of the two ramp times. When the move is too short for that,
+ * both ramps are shortened in proportion and the move has no cruise.
+ * A move started while the motor is still moving replaces it.
+ * */
+void MOTION_move(DcMotor_State a_direction, uint32 a_cruise_time_ms){
+	uint32 ramps_time = (uint32)g_motionConfig.accel_time_ms + g_motionConfig.decel_time_ms;
+
+	/*the tick leaves an idle move alone while it is set up*/
+	g_motionState = MOTION_IDLE;
+
+	g_motionDirection = a_direction;
+	g_motionAccelTime = g_motionConfig.accel_time_ms;
+	g_motionDecelTime = g_motionConfig.decel_time_ms;
+
+	if(ramps_time <= 2 * a_cruise_time_ms){
+		g_motionCruiseTime = a_cruise_time_ms - ramps_time / 2;
+	}
+	else{
+		g_motionAccelTime = (g_motionAccelTime * 2 * a_cruise_time_ms) / ramps_time;
+		g_motionDecelTime = (g_motionDecelTime * 2 * a_cruise_time_ms) / ramps_time;
+		g_motionCruiseTime = 0;
+	}
+
+	g_motionPhaseElapsed = 0;
+	g_motionFraction = 0;
+	g_motionDistance = 0;
+	g_motionTarget = a_cruise_time_ms * MOTION_RAMP_SCALE;
+	g_motionProgress = 0;
+	g_motionStopRequest = FALSE;
+	g_motionSlowRequest = FALSE;
+	g_motionStopped = FALSE;
+
+	if(g_motionTarget == 0){
+		g_motionProgress = 100;
+		return;
+	}
+
+	g_motionState = MOTION_ACCELERATING;
+}
+
+/*Description:
+ * Ramp down from the current speed to standstill over the deceleration time,
+ * the request is served by the next update of the tick.
+ * */
+void MOTION_stop(void){
+	if(g_motionState != MOTION_IDLE){
+		g_motionStopRequest = TRUE;
+	}
+}
+
+/*Description:
+ * Ramp down from the current speed to the creep speed over the deceleration time,
+ * then keep creeping until the move is halted or stopped.
+ * */
+void MOTION_slowDown(void){
+	if(g_motionState != MOTION_IDLE){
+		g_motionSlowRequest = TRUE;
+	}
+}
+
+/*Description:
+ * End the move at once because its target is reached: the motor brakes or coasts
+ * as at the end of a move and the progress is complete.
+ * Also safe from an ISR: the move is idle before the motor is stopped.
+ * */
+void MOTION_halt(void){
+	if(g_motionState == MOTION_IDLE){
+		return;
+	}
+
+	g_motionState = MOTION_IDLE;
+	g_motionProgress = 100;
+	if(g_motionConfig.brake_at_end){
+		DcMotor_brake();
+	}
+	else{
+		DcMotor_coast();
+	}
+}
+
+/*Description:
+ * Cancel the move at once and let the motor coast, e.g. on a motor fault.
+ * Also safe from the system tick: the move is idle before the motor is released.
+ * */
+void MOTION_abort(void){
+	g_motionState = MOTION_IDLE;
+	DcMotor_coast();
+}
+
+/*Description:
+ * Return the phase of the current move, MOTION_IDLE when the motor is stopped.
+ * */
+MOTION_State MOTION_getState(void){
+	return g_motionState;
+}
+
+/*Description:
+ * Return the distance covered by the current (or last) move
+ * as a percentage of the requested distance.
+ * */
+uint8 MOTION_getProgress(void){
+	return g_motionProgress;
+}
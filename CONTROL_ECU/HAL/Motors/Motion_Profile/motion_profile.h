@@ -0,0 +1,100 @@
+/******************************************************************************
+ * [FILE NAME]:     motion_profile.h
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Header file for the motion profiles of the DC Motor
+ *******************************************************************************/
+
+#ifndef MOTION_PROFILE_H_
+#define MOTION_PROFILE_H_
+
+#include "../DC_Motor/dc_motor.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*the speed of a moving motor is updated from the system tick every period*/
+#define MOTION_UPDATE_PERIOD_MS		10
+
+/*fraction of the cruise speed reached along a ramp, 0 to MOTION_RAMP_SCALE*/
+#define MOTION_RAMP_SCALE			256
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+/*
+ * Shape of the speed ramps:
+ * TRAPEZOID: the speed changes linearly, constant acceleration.
+ * S_CURVE: the speed follows a smoothstep curve, the acceleration itself
+ * starts and ends at zero (no jerk at the ends of the ramps).
+ */
+typedef enum{
+	MOTION_TRAPEZOID, MOTION_S_CURVE
+}MOTION_ProfileType;
+
+typedef enum{
+	MOTION_IDLE, MOTION_ACCELERATING, MOTION_CRUISING, MOTION_DECELERATING, MOTION_CREEPING
+}MOTION_State;
+
+typedef struct{
+	MOTION_ProfileType profile;
+	uint16 accel_time_ms;		/*from standstill to the cruise speed*/
+	uint16 decel_time_ms;		/*from the cruise speed to standstill*/
+	uint8 cruise_speed;			/*percentage of the full PWM duty cycle*/
+	uint8 creep_speed;			/*percentage kept after MOTION_slowDown until the move is halted*/
+	boolean brake_at_end;		/*brake the motor at standstill instead of letting it coast*/
+}MOTION_ConfigType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*Description:
+ * Keep the profile configuration and subscribe the speed update to the system tick.
+ * The motor must be initialized first.
+ * */
+void MOTION_init(const MOTION_ConfigType * a_config);
+
+/*Description:
+ * Start a move without blocking: ramp up, cruise then ramp down to standstill.
+ * The length of the move is the time it takes at the cruise speed without ramps,
+ * the ramps stretch the move so the motor covers the same distance.
+ * A move too short for its two ramps gets shorter ramps and no cruise.
+ * */
+void MOTION_move(DcMotor_State a_direction, uint32 a_cruise_time_ms);
+
+/*Description:
+ * Ramp down from the current speed to standstill over the deceleration time.
+ * */
+void MOTION_stop(void);
+
+/*Description:
+ * Ramp down from the current speed to the creep speed over the deceleration time,
+ * then keep creeping until the move is halted or stopped.
+ * */
+void MOTION_slowDown(void);
+
+/*Description:
+ * End the move at once because its target is reached: the motor brakes or coasts
+ * as at the end of a move and the progress is complete.
+ * */
+void MOTION_halt(void);
+
+/*Description:
+ * Cancel the move at once and let the motor coast, e.g. on a motor fault.
+ * */
+void MOTION_abort(void);
+
+/*Description:
+ * Return the phase of the current move, MOTION_IDLE when the motor is stopped.
+ * */
+MOTION_State MOTION_getState(void);
+
+/*Description:
+ * Return the distance covered by the current (or last) move
+ * as a percentage of the requested distance.
+ * */
+uint8 MOTION_getProgress(void);
+
+#endif /* MOTION_PROFILE_H_ */
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * [FILE NAME]:     obstacle.c
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Source file for the obstacle sensor of the door
+ *******************************************************************************/
+
+#include "../../MCAL/GPIO/gpio.h"
+#include "../../MCAL/Timer/systick.h"
+#include "obstacle.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile boolean g_obstacleTriggered = FALSE;
+static uint8 g_obstacleSamples = 0;
+static void (*g_obstacleCallBack)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*Description:
+ * Called from the system tick while armed: confirm an obstacle and notify once.
+ * */
+static void OBSTACLE_sample(void);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*Description:
+ * Called from the system tick while armed: confirm an obstacle and notify once,
+ * the sampling stops with the first obstacle.
+ * */
+static void OBSTACLE_sample(void){
+	if(GPIO_readPin(OBSTACLE_PORT_ID, OBSTACLE_PIN_ID) != OBSTACLE_ACTIVE_LEVEL){
+		g_obstacleSamples = 0;
+		return;
+	}
+
+	if(++g_obstacleSamples >= OBSTACLE_CONFIRM_SAMPLES){
+		SYSTICK_unsubscribe(OBSTACLE_sample);
+		g_obstacleTriggered = TRUE;
+
+		if(g_obstacleCallBack != NULL_PTR){
+			(*g_obstacleCallBack)();
+		}
+	}
+}
+
+/*Description:
+ * Setup the input of the beam sensor, the sampling starts when the sensor is armed.
+ * */
+void OBSTACLE_init(void){
+	GPIO_setupPinDirection(OBSTACLE_PORT_ID, OBSTACLE_PIN_ID, PIN_INPUT);
+	GPIO_writePin(OBSTACLE_PORT_ID, OBSTACLE_PIN_ID, LOGIC_HIGH);
+}
+
+/*Description:
+ * Function called from the system tick when an obstacle is confirmed.
+ * */
+void OBSTACLE_setCallBack(void (*a_ptr)(void)){
+	g_obstacleCallBack = a_ptr;
+}
+
+/*Description:
+ * Forget the last obstacle and sample the sensor until it triggers or is disarmed.
+ * Returns FALSE if the sampling could not be subscribed to the system tick.
+ * */
+boolean OBSTACLE_arm(void){
+	SYSTICK_unsubscribe(OBSTACLE_sample);
+	g_obstacleTriggered = FALSE;
+	g_obstacleSamples = 0;
+	return SYSTICK_subscribe(OBSTACLE_sample, OBSTACLE_SAMPLE_PERIOD_MS);
+}
+
+/*Description:
+ * Stop sampling the sensor, the last obstacle is kept.
+ * */
+void OBSTACLE_disarm(void){
+	SYSTICK_unsubscribe(OBSTACLE_sample);
+}
+
+/*Description:
+ * Return TRUE if an obstacle was confirmed since the sensor was armed.
+ * */
+boolean OBSTACLE_isTriggered(void){
+	return g_obstacleTriggered;
+}
+
+/*Description:
+ * Return TRUE if the beam is broken now.
+ * */
+boolean OBSTACLE_isBlocked(void){
+	return (GPIO_readPin(OBSTACLE_PORT_ID, OBSTACLE_PIN_ID) == OBSTACLE_ACTIVE_LEVEL);
+}
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * [FILE NAME]:     obstacle.h
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Header file for the obstacle sensor of the door
+ *******************************************************************************/
+
+#ifndef OBSTACLE_H_
+#define OBSTACLE_H_
+
+#include "../../Utils/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*output of the light beam receiver, its contact opens when the beam is broken (pulled up)*/
+#define OBSTACLE_PORT_ID			PORTA_ID
+#define OBSTACLE_PIN_ID				PIN1_ID
+#define OBSTACLE_ACTIVE_LEVEL		LOGIC_HIGH
+
+/*
+ * While armed the input is sampled from the system tick, an obstacle is confirmed
+ * after OBSTACLE_CONFIRM_SAMPLES samples in a row: the callback runs at most
+ * OBSTACLE_SAMPLE_PERIOD_MS * OBSTACLE_CONFIRM_SAMPLES ms after the beam is broken.
+ */
+#define OBSTACLE_SAMPLE_PERIOD_MS	1
+#define OBSTACLE_CONFIRM_SAMPLES	3
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*Description:
+ * Setup the input of the beam sensor, the sampling starts when the sensor is armed.
+ * */
+void OBSTACLE_init(void);
+
+/*Description:
+ * Function called from the system tick when an obstacle is confirmed.
+ * */
+void OBSTACLE_setCallBack(void (*a_ptr)(void));
+
+/*Description:
+ * Forget the last obstacle and sample the sensor until it triggers or is disarmed.
+ * Returns FALSE if the sampling could not be subscribed to the system tick.
+ * */
+boolean OBSTACLE_arm(void);
+
+/*Description:
+ * Stop sampling the sensor, the last obstacle is kept.
+ * */
+void OBSTACLE_disarm(void);
+
+/*Description:
+ * Return TRUE if an obstacle was confirmed since the sensor was armed.
+ * */
+boolean OBSTACLE_isTriggered(void);
+
+/*Description:
+ * Return TRUE if the beam is broken now.
+ * */
+boolean OBSTACLE_isBlocked(void);
+
+#endif /* OBSTACLE_H_ */
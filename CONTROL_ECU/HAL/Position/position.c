@@ -0,0 +1,222 @@
+/******************************************************************************
+ * [FILE NAME]:     position.c
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Source file for the door position sensors
+ *******************************************************************************/
+
+#include "../../MCAL/GPIO/gpio.h"
+#include "../../MCAL/EXTI/exti.h"
+#include "../../MCAL/Timer/timer_manager.h"
+#include "../Motors/DC_Motor/dc_motor.h"
+#include "position.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#if (POSITION_USE_ENCODER == 1) && (DC_MOTOR_PWM_SOURCE == DC_MOTOR_PWM_TIMER1)
+#error "The encoder needs timer1 free running, it can't be fitted with the timer1 PWM of the motor"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+#if (POSITION_USE_ENCODER == 1)
+/*same base as the profiler: timer1 free running at F_CPU/8*/
+static const TIMER_ConfigType g_encoderTimerConfig =
+{
+		.timer_id = TIMER1_ID,
+		.mode = OVERFLOW_MODE,
+		.prescaler.timer1 = TIMER1_F_CPU_8,
+		.ocx_pin_behavior = DISCONNECT_OCX,
+		.mode_data.ovf_initial_value = 0,
+};
+#endif
+
+/*encoder pulses from the closed position, also set by the end-stops*/
+static volatile uint16 g_positionPulses = 0;
+
+static volatile boolean g_positionArmed = FALSE;
+static volatile POSITION_Target g_positionTarget = POSITION_CLOSED;
+static void (*g_positionCallBack)(void) = NULL_PTR;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*Description:
+ * Called from an ISR when the door is at a_target: notify once if it is the armed target.
+ * */
+static void POSITION_arrived(POSITION_Target a_target);
+
+#if (POSITION_USE_END_STOPS == 1)
+static void POSITION_closedEndStop(void);
+static void POSITION_openEndStop(void);
+#endif
+
+#if (POSITION_USE_ENCODER == 1)
+static void POSITION_encoderPulse(void);
+#endif
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*Description:
+ * Called from an ISR when the door is at a_target: notify once if it is the armed target.
+ * */
+static void POSITION_arrived(POSITION_Target a_target){
+	if(g_positionArmed && g_positionTarget == a_target){
+		g_positionArmed = FALSE;
+		if(g_positionCallBack != NULL_PTR){
+			(*g_positionCallBack)();
+		}
+	}
+}
+
+#if (POSITION_USE_END_STOPS == 1)
+
+/*Description:
+ * INT1 ISR: the door pressed the closed end-stop, the encoder count is homed.
+ * */
+static void POSITION_closedEndStop(void){
+	g_positionPulses = 0;
+	POSITION_arrived(POSITION_CLOSED);
+}
+
+/*Description:
+ * INT2 ISR: the door pressed the open end-stop.
+ * */
+static void POSITION_openEndStop(void){
+	g_positionPulses = POSITION_TRAVEL_PULSES;
+	POSITION_arrived(POSITION_OPEN);
+}
+
+#endif
+
+#if (POSITION_USE_ENCODER == 1)
+
+/*Description:
+ * Timer1 capture ISR: count one encoder pulse in the direction the motor was last driven.
+ * With end-stops fitted they end the moves, the count only tells how far the door is.
+ * */
+static void POSITION_encoderPulse(void){
+	DcMotor_Status status;
+
+	DcMotor_getStatus(&status);
+	if(status.direction == CW){
+		if(g_positionPulses < POSITION_TRAVEL_PULSES){
+			g_positionPulses++;
+		}
+	}
+	else if(g_positionPulses != 0){
+		g_positionPulses--;
+	}
+
+#if (POSITION_USE_END_STOPS == 0)
+	if(g_positionPulses == 0){
+		POSITION_arrived(POSITION_CLOSED);
+	}
+	else if(g_positionPulses == POSITION_TRAVEL_PULSES){
+		POSITION_arrived(POSITION_OPEN);
+	}
+#endif
+}
+
+#endif
+
+/*Description:
+ * Setup the end-stop inputs and the encoder capture of the fitted sensors.
+ * The encoder count starts at the closed position, or where an end-stop says the door is.
+ * The encoder is left off if timer1 already runs with another base (only the end-stops move the count).
+ * */
+void POSITION_init(void){
+#if (POSITION_USE_END_STOPS == 1)
+	GPIO_setupPinDirection(POSITION_CLOSED_PORT_ID, POSITION_CLOSED_PIN_ID, PIN_INPUT);
+	GPIO_writePin(POSITION_CLOSED_PORT_ID, POSITION_CLOSED_PIN_ID, LOGIC_HIGH);
+	GPIO_setupPinDirection(POSITION_OPEN_PORT_ID, POSITION_OPEN_PIN_ID, PIN_INPUT);
+	GPIO_writePin(POSITION_OPEN_PORT_ID, POSITION_OPEN_PIN_ID, LOGIC_HIGH);
+
+	if(GPIO_readPin(POSITION_OPEN_PORT_ID, POSITION_OPEN_PIN_ID) == LOGIC_LOW){
+		g_positionPulses = POSITION_TRAVEL_PULSES;
+	}
+
+	EXTI_setCallBack(POSITION_CLOSED_EXTI_ID, POSITION_closedEndStop);
+	EXTI_setCallBack(POSITION_OPEN_EXTI_ID, POSITION_openEndStop);
+	EXTI_enable(POSITION_CLOSED_EXTI_ID, EXTI_FALLING_EDGE);
+	EXTI_enable(POSITION_OPEN_EXTI_ID, EXTI_FALLING_EDGE);
+#endif
+
+#if (POSITION_USE_ENCODER == 1)
+	GPIO_setupPinDirection(POSITION_ENCODER_PORT_ID, POSITION_ENCODER_PIN_ID, PIN_INPUT);
+	GPIO_writePin(POSITION_ENCODER_PORT_ID, POSITION_ENCODER_PIN_ID, LOGIC_HIGH);
+
+	/*the pulses are only counted with the capture running on the free-running base*/
+	if(TIMER_claimChannel(TIMER_CLIENT_ENCODER, TIMER1_CHANNEL_ICP, &g_encoderTimerConfig) == TIMER_CLAIM_OK){
+		TIMER_subscribe(TIMER1_EVENT_CAPT, POSITION_encoderPulse, 1);
+	}
+#endif
+}
+
+/*Description:
+ * Function called from an ISR as soon as the door reaches the armed target.
+ * */
+void POSITION_setTargetCallBack(void (*a_ptr)(void)){
+	g_positionCallBack = a_ptr;
+}
+
+/*Description:
+ * Watch for the door reaching a target, until it is reached or POSITION_disarm is called.
+ * The caller checks POSITION_isAt after arming, the door may already be there.
+ * */
+void POSITION_arm(POSITION_Target a_target){
+	g_positionArmed = FALSE;
+	g_positionTarget = a_target;
+	g_positionArmed = TRUE;
+}
+
+/*Description:
+ * Stop watching for the target.
+ * */
+void POSITION_disarm(void){
+	g_positionArmed = FALSE;
+}
+
+/*Description:
+ * Return TRUE if a sensor tells the door is at the target:
+ * the end-stop when they are fitted, else the encoder count.
+ * */
+boolean POSITION_isAt(POSITION_Target a_target){
+#if (POSITION_USE_END_STOPS == 1)
+	if(a_target == POSITION_OPEN){
+		return (GPIO_readPin(POSITION_OPEN_PORT_ID, POSITION_OPEN_PIN_ID) == LOGIC_LOW);
+	}
+	return (GPIO_readPin(POSITION_CLOSED_PORT_ID, POSITION_CLOSED_PIN_ID) == LOGIC_LOW);
+#elif (POSITION_USE_ENCODER == 1)
+	return (POSITION_getRemaining(a_target) == 0);
+#else
+	return FALSE;
+#endif
+}
+
+/*Description:
+ * Return the number of encoder pulses left to reach a target,
+ * read again if the ISR changed the count during the copy.
+ * */
+uint16 POSITION_getRemaining(POSITION_Target a_target){
+	uint16 pulses;
+
+	do{
+		pulses = g_positionPulses;
+	}while(pulses != g_positionPulses);
+
+	return (a_target == POSITION_OPEN) ? POSITION_TRAVEL_PULSES - pulses : pulses;
+}
+
+/*Description:
+ * Return the encoder position from 0 (closed) to 100 (open).
+ * */
+uint8 POSITION_getPercent(void){
+	return (uint8)(((uint32)(POSITION_TRAVEL_PULSES - POSITION_getRemaining(POSITION_OPEN)) * 100) / POSITION_TRAVEL_PULSES);
+}
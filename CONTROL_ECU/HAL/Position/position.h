@@ -0,0 +1,87 @@
+/******************************************************************************
+ * [FILE NAME]:     position.h
+ * [AUTHOR]:        Marwan Shehata
+ * [DESCRIPTION]:   Header file for the door position sensors
+ *******************************************************************************/
+
+#ifndef POSITION_H_
+#define POSITION_H_
+
+#include "../../Utils/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*set to 0 the sensors that are not fitted, with none the door moves for a fixed time*/
+#define POSITION_USE_END_STOPS		1
+#define POSITION_USE_ENCODER		1
+
+/*end-stop switches to ground with the internal pull-ups, a falling edge when the door arrives*/
+#define POSITION_CLOSED_EXTI_ID		EXTI_INT1
+#define POSITION_CLOSED_PORT_ID		PORTD_ID
+#define POSITION_CLOSED_PIN_ID		PIN3_ID
+
+#define POSITION_OPEN_EXTI_ID		EXTI_INT2
+#define POSITION_OPEN_PORT_ID		PORTB_ID
+#define POSITION_OPEN_PIN_ID		PIN2_ID
+
+/*
+ * Pulse encoder on ICP1 (PD6): every falling edge is captured by timer1 and counted
+ * up while the motor opens the door (CW) and down while it closes it (ACW).
+ * Timer1 runs free with the base of the profiler so both can share it.
+ */
+#define POSITION_ENCODER_PORT_ID	PORTD_ID
+#define POSITION_ENCODER_PIN_ID		PIN6_ID
+#define POSITION_TRAVEL_PULSES		1200	/*pulses from the closed to the open position*/
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	POSITION_CLOSED, POSITION_OPEN
+}POSITION_Target;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*Description:
+ * Setup the end-stop inputs and the encoder capture of the fitted sensors.
+ * The encoder count starts at the closed position, or where an end-stop says the door is.
+ * The encoder is left off if timer1 already runs with another base (only the end-stops move the count).
+ * */
+void POSITION_init(void);
+
+/*Description:
+ * Function called from an ISR as soon as the door reaches the armed target.
+ * */
+void POSITION_setTargetCallBack(void (*a_ptr)(void));
+
+/*Description:
+ * Watch for the door reaching a target, until it is reached or POSITION_disarm is called.
+ * */
+void POSITION_arm(POSITION_Target a_target);
+
+/*Description:
+ * Stop watching for the target.
+ * */
+void POSITION_disarm(void);
+
+/*Description:
+ * Return TRUE if a sensor tells the door is at the target.
+ * */
+boolean POSITION_isAt(POSITION_Target a_target);
+
+/*Description:
+ * Return the number of encoder pulses left to reach a target.
+ * */
+uint16 POSITION_getRemaining(POSITION_Target a_target);
+
+/*Description:
+ * Return the encoder position from 0 (closed) to 100 (open).
+ * */
+uint8 POSITION_getPercent(void);
+
+#endif /* POSITION_H_ */
@@ -0,0 +1,212 @@
+/******************************************************************************
+ * [FILE NAME]:     adc.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the Analog to Digital Converter driver
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "adc.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static ADC_Channel g_adcSequence[ADC_MAX_SEQUENCE];
+static uint8 g_adcSequenceLength = 0;
+static uint8 g_adcReferenceBits = 0;
+
+/*position in the sequence of the next result and of the channel loaded in ADMUX*/
+static uint8 g_adcConvertingIndex = 0;
+static uint8 g_adcMuxIndex = 0;
+static boolean g_adcFreeRunning = FALSE;
+
+/*TIFR flag of the timer trigger, cleared after each conversion so its next rising edge starts a new one*/
+static uint8 g_adcTriggerFlag = 0;
+
+/*the ISR writes at the head and the application reads at the tail*/
+static ADC_Sample g_adcRing[ADC_RING_SIZE];
+static volatile uint8 g_adcRingHead = 0;
+static volatile uint8 g_adcRingTail = 0;
+
+static volatile uint16 g_adcLatest[ADC_MAX_SEQUENCE];
+static volatile uint16 g_adcOverruns = 0;
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(ADC_vect){
+	uint16 value = ADCW;
+	uint8 next_head = (g_adcRingHead + 1) & (ADC_RING_SIZE - 1);
+
+	g_adcLatest[g_adcConvertingIndex] = value;
+
+	if(next_head == g_adcRingTail){
+		g_adcOverruns++;
+	}
+	else{
+		g_adcRing[g_adcRingHead].channel = g_adcSequence[g_adcConvertingIndex];
+		g_adcRing[g_adcRingHead].value = value;
+		g_adcRingHead = next_head;
+	}
+
+	/*
+	 * ADMUX is latched when a conversion starts. In free running mode the next conversion
+	 * has already started with the channel loaded so far, the new channel is for the one after it.
+	 * A trigger starts the next conversion later, with the new channel.
+	 */
+	if(g_adcFreeRunning){
+		g_adcConvertingIndex = g_adcMuxIndex;
+	}
+	g_adcMuxIndex = (g_adcMuxIndex + 1 < g_adcSequenceLength) ? g_adcMuxIndex + 1 : 0;
+	ADMUX = g_adcReferenceBits | g_adcSequence[g_adcMuxIndex];
+	if(!g_adcFreeRunning){
+		g_adcConvertingIndex = g_adcMuxIndex;
+	}
+
+	if(g_adcTriggerFlag != 0){
+		TIFR = g_adcTriggerFlag;	/*a flag is cleared by writing one to it*/
+	}
+}
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the reference, the clock and the trigger of the ADC,
+ * then start converting the channels of the sequence in turn.
+ */
+void ADC_init(const ADC_ConfigType * const a_adcConfig){
+	uint8 sreg = SREG;
+	uint8 index;
+
+	if(a_adcConfig->sequence_length == 0 || a_adcConfig->sequence_length > ADC_MAX_SEQUENCE){
+		return;
+	}
+
+	cli();
+	ADCSRA = 0;
+
+	g_adcSequenceLength = a_adcConfig->sequence_length;
+	for(index = 0; index < g_adcSequenceLength; index++){
+		g_adcSequence[index] = a_adcConfig->sequence[index] & 0x07;
+		g_adcLatest[index] = 0;
+
+		/*analog inputs without pull-up*/
+		CLEAR_BIT(DDRA, g_adcSequence[index]);
+		CLEAR_BIT(PORTA, g_adcSequence[index]);
+	}
+	g_adcRingHead = 0;
+	g_adcRingTail = 0;
+	g_adcOverruns = 0;
+	g_adcReferenceBits = (a_adcConfig->reference & 0x03) << REFS0;
+	g_adcFreeRunning = (a_adcConfig->trigger == ADC_FREE_RUNNING);
+
+	switch(a_adcConfig->trigger){
+	case ADC_TIMER0_COMPARE:
+		g_adcTriggerFlag = (1 << OCF0);
+		break;
+	case ADC_TIMER0_OVERFLOW:
+		g_adcTriggerFlag = (1 << TOV0);
+		break;
+	case ADC_TIMER1_COMPARE_B:
+		g_adcTriggerFlag = (1 << OCF1B);
+		break;
+	case ADC_TIMER1_OVERFLOW:
+		g_adcTriggerFlag = (1 << TOV1);
+		break;
+	case ADC_TIMER1_CAPTURE:
+		g_adcTriggerFlag = (1 << ICF1);
+		break;
+	default:
+		g_adcTriggerFlag = 0;
+		break;
+	}
+
+	/*right adjusted result, first channel of the sequence*/
+	g_adcConvertingIndex = 0;
+	g_adcMuxIndex = 0;
+	ADMUX = g_adcReferenceBits | g_adcSequence[0];
+
+	SFIOR = (SFIOR & 0x1F) | ((a_adcConfig->trigger & 0x07) << ADTS0);
+	if(g_adcTriggerFlag != 0){
+		TIFR = g_adcTriggerFlag;
+	}
+
+	ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIF) | (1 << ADIE) | (a_adcConfig->prescaler & 0x07);
+
+	if(g_adcFreeRunning){
+		/*the first conversion is started by hand, the second one follows it on the same channel*/
+		SET_BIT(ADCSRA, ADSC);
+	}
+
+	SREG = sreg;
+}
+
+/*
+ * Description :
+ * Stop the conversions and turn the ADC off.
+ */
+void ADC_deInit(void){
+	ADCSRA = (1 << ADIF);
+	SFIOR &= 0x1F;
+}
+
+/*
+ * Description :
+ * Move up to a_max samples from the ring to a_samples, oldest first.
+ * Returns the number of samples copied.
+ */
+uint8 ADC_readSamples(ADC_Sample * a_samples, uint8 a_max){
+	uint8 count = 0;
+	uint8 tail = g_adcRingTail;
+
+	while(count < a_max && tail != g_adcRingHead){
+		a_samples[count++] = g_adcRing[tail];
+		tail = (tail + 1) & (ADC_RING_SIZE - 1);
+	}
+
+	/*the slots are given back to the ISR only after they were copied*/
+	g_adcRingTail = tail;
+
+	return count;
+}
+
+/*
+ * Description :
+ * Return the last value converted for a position of the sequence.
+ */
+uint16 ADC_getLatest(uint8 a_index){
+	uint16 value;
+	uint8 sreg = SREG;
+
+	if(a_index >= g_adcSequenceLength){
+		return 0;
+	}
+
+	/*a 16-bit read is not atomic on the AVR*/
+	cli();
+	value = g_adcLatest[a_index];
+	SREG = sreg;
+
+	return value;
+}
+
+/*
+ * Description :
+ * Return the number of samples dropped because the ring was full.
+ */
+uint16 ADC_getOverruns(void){
+	uint16 overruns;
+	uint8 sreg = SREG;
+
+	cli();
+	overruns = g_adcOverruns;
+	SREG = sreg;
+
+	return overruns;
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * [FILE NAME]:     adc.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the Analog to Digital Converter driver
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include "../../Utils/std_types.h"
+#include "../../Utils/common_macros.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define ADC_MAX_VALUE			1023
+#define ADC_RING_SIZE			16		/*samples kept until they are read, a power of two*/
+#define ADC_MAX_SEQUENCE		8		/*channels converted one after the other*/
+
+/*
+ * The conversions run by themselves once started, the ISR stores each result
+ * in a ring of samples (like a DMA channel) and loads the next channel of the sequence.
+ * A full ring drops the new samples and counts them as overruns.
+ */
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*the value is the REFS1:REFS0 bits of ADMUX*/
+typedef enum{
+	ADC_AREF, ADC_AVCC, ADC_INTERNAL_2_56V = 3
+}ADC_ReferenceVoltage;
+
+/*the value is the ADPS2:0 bits of ADCSRA, the ADC clock must be 50 to 200 KHz for 10 bits*/
+typedef enum{
+	ADC_F_CPU_2 = 1, ADC_F_CPU_4, ADC_F_CPU_8, ADC_F_CPU_16, ADC_F_CPU_32, ADC_F_CPU_64, ADC_F_CPU_128
+}ADC_Prescaler;
+
+/*
+ * The value is the ADTS2:0 bits of SFIOR.
+ * FREE_RUNNING starts a conversion as soon as the previous one completes (13 ADC clocks),
+ * the other sources start one conversion on each rising edge of their interrupt flag.
+ */
+typedef enum{
+	ADC_FREE_RUNNING, ADC_ANALOG_COMPARATOR, ADC_EXTERNAL_INT0, ADC_TIMER0_COMPARE,
+	ADC_TIMER0_OVERFLOW, ADC_TIMER1_COMPARE_B, ADC_TIMER1_OVERFLOW, ADC_TIMER1_CAPTURE
+}ADC_TriggerSource;
+
+typedef enum{
+	ADC_CHANNEL_0, ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_3,
+	ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_6, ADC_CHANNEL_7
+}ADC_Channel;
+
+typedef struct{
+	ADC_Channel channel;
+	uint16 value;
+}ADC_Sample;
+
+typedef struct{
+	ADC_ReferenceVoltage reference;
+	ADC_Prescaler prescaler;
+	ADC_TriggerSource trigger;
+	const ADC_Channel * sequence;	/*channels converted in turn, on pins PA0 to PA7*/
+	uint8 sequence_length;			/*1 to ADC_MAX_SEQUENCE*/
+}ADC_ConfigType;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the reference, the clock and the trigger of the ADC,
+ * then start converting the channels of the sequence in turn.
+ */
+void ADC_init(const ADC_ConfigType * const a_adcConfig);
+
+/*
+ * Description :
+ * Stop the conversions and turn the ADC off.
+ */
+void ADC_deInit(void);
+
+/*
+ * Description :
+ * Move up to a_max samples from the ring to a_samples, oldest first.
+ * Returns the number of samples copied.
+ */
+uint8 ADC_readSamples(ADC_Sample * a_samples, uint8 a_max);
+
+/*
+ * Description :
+ * Return the last value converted for a position of the sequence.
+ */
+uint16 ADC_getLatest(uint8 a_index);
+
+/*
+ * Description :
+ * Return the number of samples dropped because the ring was full.
+ */
+uint16 ADC_getOverruns(void);
+
+#endif /* ADC_H_ */
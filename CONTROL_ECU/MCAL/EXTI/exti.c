@@ -0,0 +1,93 @@
+/******************************************************************************
+ * [FILE NAME]:     exti.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the External Interrupts driver
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "exti.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static void (*g_extiCallBack[EXTI_NUM_OF_INTERRUPTS])(void) = {NULL_PTR};
+
+/*enable bits in GICR and flag bits in GIFR of each interrupt*/
+static const uint8 g_extiBit[EXTI_NUM_OF_INTERRUPTS] = {INT0, INT1, INT2};
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+
+ISR(INT0_vect){
+	if(g_extiCallBack[EXTI_INT0] != NULL_PTR){
+		(*g_extiCallBack[EXTI_INT0])();
+	}
+}
+
+ISR(INT1_vect){
+	if(g_extiCallBack[EXTI_INT1] != NULL_PTR){
+		(*g_extiCallBack[EXTI_INT1])();
+	}
+}
+
+ISR(INT2_vect){
+	if(g_extiCallBack[EXTI_INT2] != NULL_PTR){
+		(*g_extiCallBack[EXTI_INT2])();
+	}
+}
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+void EXTI_enable(EXTI_ID a_id, EXTI_SenseControl a_sense){
+	uint8 sreg = SREG;
+
+	if(a_id >= EXTI_NUM_OF_INTERRUPTS){
+		return;
+	}
+
+	cli();
+	switch(a_id){
+	case EXTI_INT0:
+		/*ISC01:ISC00 bits 1:0 of MCUCR*/
+		MCUCR = (MCUCR & 0xFC) | (a_sense & 0x03);
+		break;
+	case EXTI_INT1:
+		/*ISC11:ISC10 bits 3:2 of MCUCR*/
+		MCUCR = (MCUCR & 0xF3) | ((a_sense & 0x03) << 2);
+		break;
+	default:
+		/*changing ISC2 can set the flag, the interrupt is disabled meanwhile*/
+		CLEAR_BIT(GICR, INT2);
+		if(a_sense == EXTI_RISING_EDGE){
+			SET_BIT(MCUCSR, ISC2);
+		}
+		else{
+			CLEAR_BIT(MCUCSR, ISC2);
+		}
+		break;
+	}
+
+	GIFR = (1 << g_extiBit[a_id]);	/*a flag is cleared by writing one to it*/
+	SET_BIT(GICR, g_extiBit[a_id]);
+	SREG = sreg;
+}
+
+void EXTI_disable(EXTI_ID a_id){
+	if(a_id >= EXTI_NUM_OF_INTERRUPTS){
+		return;
+	}
+	CLEAR_BIT(GICR, g_extiBit[a_id]);
+}
+
+void EXTI_setCallBack(EXTI_ID a_id, void (*a_ptr)(void)){
+	if(a_id >= EXTI_NUM_OF_INTERRUPTS){
+		return;
+	}
+	g_extiCallBack[a_id] = a_ptr;
+}
@@ -0,0 +1,55 @@
+/******************************************************************************
+ * [FILE NAME]:     exti.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the External Interrupts driver
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef EXTI_H_
+#define EXTI_H_
+
+#include "../../Utils/std_types.h"
+#include "../../Utils/common_macros.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*INT0 on PD2, INT1 on PD3, INT2 on PB2*/
+typedef enum{
+	EXTI_INT0, EXTI_INT1, EXTI_INT2, EXTI_NUM_OF_INTERRUPTS
+}EXTI_ID;
+
+/*
+ * Only the low level of INT0/INT1 and the edges of INT2 (asynchronous)
+ * can wake the MCU from Power-down.
+ */
+typedef enum{
+	EXTI_LOW_LEVEL, EXTI_ANY_CHANGE, EXTI_FALLING_EDGE, EXTI_RISING_EDGE
+}EXTI_SenseControl;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Select the sense of an interrupt, clear its flag and enable it.
+ * INT2 has no level or any change sense, the falling edge is used instead of them.
+ * The pin direction and pull up are set by the user of the interrupt.
+ */
+void EXTI_enable(EXTI_ID a_id, EXTI_SenseControl a_sense);
+
+/*
+ * Description :
+ * Disable an interrupt, its callback is kept.
+ */
+void EXTI_disable(EXTI_ID a_id);
+
+/*
+ * Description :
+ * Set the function called from the ISR of an interrupt.
+ */
+void EXTI_setCallBack(EXTI_ID a_id, void (*a_ptr)(void));
+
+#endif /* EXTI_H_ */
@@ -298,6 +298,34 @@ void GPIO_writeNibble(uint8 port_num, uint8 value, GPIO_NibbleSignificance nibbl
 	}
 }
 
+/*
+ * Description :
+ * Write the bits of value selected by mask on the required port in a single register write,
+ * the other pins of the port keep their value.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writePortMasked(uint8 port_num, uint8 mask, uint8 value){
+	if(port_num>=NUM_OF_PORTS){
+		/*Do nothing if the port number is greater than or equal the maximum allowed number */
+	}
+	else{
+		switch(port_num){
+		case PORTA_ID:
+			PORTA = (PORTA & ~mask) | (value & mask);
+			break;
+		case PORTB_ID:
+			PORTB = (PORTB & ~mask) | (value & mask);
+			break;
+		case PORTC_ID:
+			PORTC = (PORTC & ~mask) | (value & mask);
+			break;
+		case PORTD_ID:
+			PORTD = (PORTD & ~mask) | (value & mask);
+			break;
+		}
+	}
+}
+
 /*
  * Description :
  * Read and return the value of the required nibble.
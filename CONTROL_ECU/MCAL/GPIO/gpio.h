@@ -148,4 +148,12 @@ uint8 GPIO_readNibble(uint8 port_num, GPIO_NibbleSignificance nibble_choice );
  */
 void GPIO_writeNibble(uint8 port_num, uint8 value, GPIO_NibbleSignificance nibble_choice);
 
+/*
+ * Description :
+ * Write the bits of value selected by mask on the required port in a single register write,
+ * the other pins of the port keep their value.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writePortMasked(uint8 port_num, uint8 mask, uint8 value);
+
 #endif /* GPIO_H_ */
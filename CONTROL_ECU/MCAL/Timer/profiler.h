@@ -0,0 +1,120 @@
+/******************************************************************************
+ * [FILE NAME]:     profiler.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the execution time profiler
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "timer_manager.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*set to 1 to compile the probes, with 0 every probe expands to nothing*/
+#define PROF_ENABLED				0
+
+/*
+ * Timer1 runs free in normal mode as the time base of all probes.
+ * With F_CPU/8 one count is 1 us (8 cycles) and a probe may last up to 65.5 ms,
+ * use TIMER1_F_CPU_1 for cycle resolution of probes shorter than 8.1 ms.
+ */
+#define PROF_PRESCALER				TIMER1_F_CPU_8
+#define PROF_CYCLES_PER_COUNT		8
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*
+ * Probes of this ECU, the list generates both the probe ids and their report names.
+ * Timer ISR probes cover the subscriber dispatch, not the ISR prologue/epilogue.
+ */
+#define PROF_PROBE_LIST(PROBE)	\
+	PROBE(TIMER0_OVF_ISR)		\
+	PROBE(TIMER0_COMP_ISR)		\
+	PROBE(TIMER1_OVF_ISR)		\
+	PROBE(TIMER1_COMPA_ISR)		\
+	PROBE(TIMER1_COMPB_ISR)		\
+	PROBE(TIMER1_CAPT_ISR)		\
+	PROBE(TIMER2_OVF_ISR)		\
+	PROBE(TIMER2_COMP_ISR)		\
+	PROBE(USART_RECEIVE_STRING)	\
+	PROBE(EEPROM_READ_BYTE)		\
+	PROBE(EEPROM_WRITE_BYTE)
+
+
+#define PROF_ID(NAME)		PROF_ID_##NAME,
+
+typedef enum{
+	PROF_PROBE_LIST(PROF_ID)
+	PROF_NUM_OF_PROBES
+}PROF_Id;
+
+typedef struct{
+	uint16 min;
+	uint16 max;
+	uint32 total;
+	uint16 count;
+}PROF_Stats;
+
+/*******************************************************************************
+ *                           Probe Macros                                      *
+ *******************************************************************************/
+
+#if (PROF_ENABLED == 1)
+
+extern volatile uint16 g_profStart[PROF_NUM_OF_PROBES];
+
+#define PROF_BEGIN(id)		(g_profStart[(id)] = PROF_readCounter())
+#define PROF_END(id)		PROF_record((id), (uint16)(PROF_readCounter() - g_profStart[(id)]))
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Start the free-running timer1 and clear the statistics of all probes.
+ */
+void PROF_init(void);
+
+/*
+ * Description :
+ * Read TCNT1, the probes do not go through the timer driver.
+ * It is defined in profiler.c as the modules with gpio.h cannot include avr/io.h.
+ */
+uint16 PROF_readCounter(void);
+
+/*
+ * Description :
+ * Add one measured duration (in timer counts) to the statistics of a probe.
+ */
+void PROF_record(PROF_Id a_id, uint16 a_counts);
+
+/*
+ * Description :
+ * Copy the statistics of a probe.
+ */
+void PROF_getStats(PROF_Id a_id, PROF_Stats * a_stats);
+
+/*
+ * Description :
+ * Send a report of all probes through the USART, one line per probe:
+ * name, count, min, max and average duration in timer counts.
+ */
+void PROF_report(void);
+
+#else
+
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+#define PROF_init()
+#define PROF_report()
+
+#endif /* PROF_ENABLED */
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * [FILE NAME]:     systick.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the 1 ms system tick
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "systick.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+static volatile uint32 g_systickMs = 0;
+
+static const TIMER_ConfigType g_systickConfig =
+{
+		.timer_id = TIMER2_ID,
+		.mode = COMPARE_MODE,
+		.prescaler.timer2 = SYSTICK_PRESCALER,
+		.ocx_pin_behavior = DISCONNECT_OCX,
+		.mode_data.ctc_compare_value = SYSTICK_COMPARE_VALUE,
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void SYSTICK_increment(void);
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+static void SYSTICK_increment(void){
+	g_systickMs++;
+}
+
+void SYSTICK_init(void){
+	/*the millisecond counter is always the first subscriber of the tick*/
+	TIMER_subscribe(TIMER2_EVENT_COMP, SYSTICK_increment, 1);
+	TIMER_claimChannel(TIMER_CLIENT_SYSTICK, TIMER2_CHANNEL_OC2, &g_systickConfig);
+}
+
+uint32 SYSTICK_getMs(void){
+	uint32 ms;
+	uint8 sreg = SREG;
+
+	/*a 32-bit read is not atomic on the AVR*/
+	cli();
+	ms = g_systickMs;
+	SREG = sreg;
+
+	return ms;
+}
+
+boolean SYSTICK_subscribe(void (*a_callback)(void), uint16 a_period_ms){
+	return TIMER_subscribe(TIMER2_EVENT_COMP, a_callback, a_period_ms);
+}
+
+void SYSTICK_unsubscribe(void (*a_callback)(void)){
+	TIMER_unsubscribe(TIMER2_EVENT_COMP, a_callback);
+}
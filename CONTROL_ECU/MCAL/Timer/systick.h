@@ -0,0 +1,51 @@
+/******************************************************************************
+ * [FILE NAME]:     systick.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the 1 ms system tick
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef SYSTICK_H_
+#define SYSTICK_H_
+
+#include "timer_manager.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*timer2 in CTC mode: 8MHz / 64 = 125KHz, 125 counts = 1 ms*/
+#define SYSTICK_PRESCALER			TIMER2_F_CPU_64
+#define SYSTICK_COMPARE_VALUE		124
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Claim the compare channel of timer2 and start counting milliseconds.
+ */
+void SYSTICK_init(void);
+
+/*
+ * Description :
+ * Return the number of milliseconds elapsed since SYSTICK_init.
+ */
+uint32 SYSTICK_getMs(void);
+
+/*
+ * Description :
+ * Call a function from the tick ISR every a_period_ms milliseconds.
+ * Callbacks run with interrupts disabled and must return quickly.
+ * Returns FALSE if no subscriber slot is left.
+ */
+boolean SYSTICK_subscribe(void (*a_callback)(void), uint16 a_period_ms);
+
+/*
+ * Description :
+ * Stop calling a function subscribed with SYSTICK_subscribe.
+ */
+void SYSTICK_unsubscribe(void (*a_callback)(void));
+
+#endif /* SYSTICK_H_ */
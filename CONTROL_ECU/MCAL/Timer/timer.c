@@ -8,64 +8,123 @@
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include "timer.h"
+#include "profiler.h"
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef struct{
+	void (*callback)(void);
+	uint16 divisor;		/*callback runs once every divisor events*/
+	uint16 countdown;	/*events left until the next call*/
+}TIMER_Subscriber;
 
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
 
-static volatile void (*g_timer0CallBackPtr) (void) = NULL_PTR;
-static volatile void (*g_timer1CallBackPtr) (void) = NULL_PTR;
-static volatile void (*g_timer2CallBackPtr) (void) = NULL_PTR;
+/*TOP of timer1 in the PWM modes, used to scale the duty cycle percentage*/
+static uint16 g_timer1Top = TOP_VALUE;
+
+static TIMER_Subscriber g_timer0OvfSubscribers[TIMER0_OVF_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer0CompSubscribers[TIMER0_COMP_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer1OvfSubscribers[TIMER1_OVF_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer1CompASubscribers[TIMER1_COMPA_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer1CompBSubscribers[TIMER1_COMPB_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer1CaptSubscribers[TIMER1_CAPT_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer2OvfSubscribers[TIMER2_OVF_MAX_SUBSCRIBERS];
+static TIMER_Subscriber g_timer2CompSubscribers[TIMER2_COMP_MAX_SUBSCRIBERS];
+
+/*subscriber table and its capacity for every event*/
+static TIMER_Subscriber * const g_eventTable[TIMER_NUM_OF_EVENTS] =
+{
+		g_timer0OvfSubscribers, g_timer0CompSubscribers,
+		g_timer1OvfSubscribers, g_timer1CompASubscribers, g_timer1CompBSubscribers, g_timer1CaptSubscribers,
+		g_timer2OvfSubscribers, g_timer2CompSubscribers
+};
+
+static const uint8 g_eventCapacity[TIMER_NUM_OF_EVENTS] =
+{
+		TIMER0_OVF_MAX_SUBSCRIBERS, TIMER0_COMP_MAX_SUBSCRIBERS,
+		TIMER1_OVF_MAX_SUBSCRIBERS, TIMER1_COMPA_MAX_SUBSCRIBERS, TIMER1_COMPB_MAX_SUBSCRIBERS, TIMER1_CAPT_MAX_SUBSCRIBERS,
+		TIMER2_OVF_MAX_SUBSCRIBERS, TIMER2_COMP_MAX_SUBSCRIBERS
+};
 
 /*******************************************************************************
  *                       Interrupt Service Routines                            *
  *******************************************************************************/
 
-ISR(TIMER0_OVF_vect){
-	if(g_timer0CallBackPtr != NULL_PTR){
-		(*g_timer0CallBackPtr)();
+/*
+ * Call the due subscribers of an event.
+ * The loop length is the compile-time capacity of the table, so the worst case
+ * cost of an ISR is fixed whatever the number of active subscribers.
+ */
+static inline void TIMER_dispatch(TIMER_Subscriber * a_table, const uint8 a_capacity){
+	uint8 i;
+	for(i = 0; i < a_capacity; i++){
+		if(a_table[i].callback != NULL_PTR && --a_table[i].countdown == 0){
+			a_table[i].countdown = a_table[i].divisor;
+			a_table[i].callback();
+		}
 	}
 }
 
+ISR(TIMER0_OVF_vect){
+	PROF_BEGIN(PROF_ID_TIMER0_OVF_ISR);
+	TIMER_dispatch(g_timer0OvfSubscribers, TIMER0_OVF_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER0_OVF_ISR);
+}
+
 ISR(TIMER0_COMP_vect){
-	if(g_timer0CallBackPtr != NULL_PTR){
-		(*g_timer0CallBackPtr)();
-	}
+	PROF_BEGIN(PROF_ID_TIMER0_COMP_ISR);
+	TIMER_dispatch(g_timer0CompSubscribers, TIMER0_COMP_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER0_COMP_ISR);
 }
 
 ISR(TIMER1_OVF_vect){
-	if(g_timer1CallBackPtr != NULL_PTR){
-		(*g_timer1CallBackPtr)();
-	}
-
+	PROF_BEGIN(PROF_ID_TIMER1_OVF_ISR);
+	TIMER_dispatch(g_timer1OvfSubscribers, TIMER1_OVF_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER1_OVF_ISR);
 }
 
 ISR(TIMER1_COMPA_vect){
-	if(g_timer1CallBackPtr != NULL_PTR){
-		(*g_timer1CallBackPtr)();
-	}
+	PROF_BEGIN(PROF_ID_TIMER1_COMPA_ISR);
+	TIMER_dispatch(g_timer1CompASubscribers, TIMER1_COMPA_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER1_COMPA_ISR);
 }
 
+ISR(TIMER1_COMPB_vect){
+	PROF_BEGIN(PROF_ID_TIMER1_COMPB_ISR);
+	TIMER_dispatch(g_timer1CompBSubscribers, TIMER1_COMPB_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER1_COMPB_ISR);
+}
+
+ISR(TIMER1_CAPT_vect){
+	PROF_BEGIN(PROF_ID_TIMER1_CAPT_ISR);
+	TIMER_dispatch(g_timer1CaptSubscribers, TIMER1_CAPT_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER1_CAPT_ISR);
+}
 
 ISR(TIMER2_OVF_vect){
-	if(g_timer2CallBackPtr != NULL_PTR){
-		(*g_timer2CallBackPtr)();
-	}
+	PROF_BEGIN(PROF_ID_TIMER2_OVF_ISR);
+	TIMER_dispatch(g_timer2OvfSubscribers, TIMER2_OVF_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER2_OVF_ISR);
 }
 
 ISR(TIMER2_COMP_vect){
-	if(g_timer2CallBackPtr != NULL_PTR){
-		(*g_timer2CallBackPtr)();
-	}
+	PROF_BEGIN(PROF_ID_TIMER2_COMP_ISR);
+	TIMER_dispatch(g_timer2CompSubscribers, TIMER2_COMP_MAX_SUBSCRIBERS);
+	PROF_END(PROF_ID_TIMER2_COMP_ISR);
 }
 
 /*******************************************************************************
  *                      Functions Prototypes(Private)                          *
  *******************************************************************************/
 
-static void TIMER0_init(TIMER_ConfigType * a_timerConfig);
-static void TIMER1_init(TIMER_ConfigType * a_timerConfig);
-static void TIMER2_init(TIMER_ConfigType * a_timerConfig);
+static void TIMER0_initBase(const TIMER_ConfigType * a_timerConfig);
+static void TIMER1_initBase(const TIMER_ConfigType * a_timerConfig);
+static void TIMER2_initBase(const TIMER_ConfigType * a_timerConfig);
 
 static void TIMER0_deInit();
 static void TIMER1_deInit();
@@ -77,47 +136,207 @@ static void TIMER2_deInit();
 
 
 void TIMER_init(TIMER_ConfigType * a_timerConfig){
+	TIMER_Channel channel;
+
+	TIMER_initBase(a_timerConfig);
+
+	/*enable the channel implied by the configuration*/
 	switch(a_timerConfig->timer_id){
 	case TIMER0_ID:
-		TIMER0_init(a_timerConfig);
+		channel = (a_timerConfig->mode == OVERFLOW_MODE) ? TIMER0_CHANNEL_OVF : TIMER0_CHANNEL_OC0;
 		break;
 	case TIMER1_ID:
-		TIMER1_init(a_timerConfig);
+		if(a_timerConfig->mode == OVERFLOW_MODE){
+			channel = TIMER1_CHANNEL_OVF;
+		}
+		else if(TIMER_IS_PWM_MODE(a_timerConfig->mode) && a_timerConfig->timer1_pwm_pin_select == PIN_OC1B){
+			channel = TIMER1_CHANNEL_OC1B;
+		}
+		else{
+			channel = TIMER1_CHANNEL_OC1A;
+		}
 		break;
 	case TIMER2_ID:
-		TIMER2_init(a_timerConfig);
+	default:
+		channel = (a_timerConfig->mode == OVERFLOW_MODE) ? TIMER2_CHANNEL_OVF : TIMER2_CHANNEL_OC2;
 		break;
 	}
+	TIMER_setupChannel(channel, a_timerConfig);
 }
 
-void TIMER_deInit(TIMER_ID a_timerId){
-	switch(a_timerId){
+void TIMER_initBase(const TIMER_ConfigType * a_timerConfig){
+	switch(a_timerConfig->timer_id){
 	case TIMER0_ID:
-		TIMER0_deInit();
+		TIMER0_initBase(a_timerConfig);
 		break;
 	case TIMER1_ID:
-		TIMER1_deInit();
+		TIMER1_initBase(a_timerConfig);
 		break;
 	case TIMER2_ID:
-		TIMER2_deInit();
+		TIMER2_initBase(a_timerConfig);
 		break;
 	}
 }
 
-void TIMER_setCallBackFunc(TIMER_ID a_timerId, void volatile (*a_functionAddressPtr) (void)){
+void TIMER_setupChannel(TIMER_Channel a_channel, const TIMER_ConfigType * a_timerConfig){
+	switch(a_channel){
+	case TIMER0_CHANNEL_OVF:
+		SET_BIT(TIMSK,TOIE0);
+		break;
+	case TIMER0_CHANNEL_OC0:
+		if(TIMER_IS_PWM_MODE(a_timerConfig->mode)){
+			OCR0 = (((uint16)a_timerConfig->mode_data.pwm_duty_cycle * TIMER0_MAX_COUNT)/100);
+			DDRB  = DDRB | (1<<OC0); //set PB3/OC0 as output pin --> pin where the PWM signal is generated from MC.
+		}
+		else{
+			OCR0 = a_timerConfig->mode_data.ctc_compare_value;
+			SET_BIT(TIMSK,OCIE0);
+		}
+		TCCR0 = (TCCR0 & ~(0x03 << COM00)) | (a_timerConfig->ocx_pin_behavior << COM00);
+		break;
+
+	case TIMER1_CHANNEL_OVF:
+		SET_BIT(TIMSK,TOIE1);
+		break;
+	case TIMER1_CHANNEL_OC1A:
+		if(TIMER_IS_PWM_MODE(a_timerConfig->mode)){
+			OCR1A = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * g_timer1Top)/100);
+			DDRD  |= (1 << OC1A);
+		}
+		else{
+			OCR1A = a_timerConfig->mode_data.ctc_compare_value;
+			SET_BIT(TIMSK,OCIE1A);
+		}
+		TCCR1A = (TCCR1A & ~(0x03 << COM1A0)) | (a_timerConfig->ocx_pin_behavior << COM1A0);
+		break;
+	case TIMER1_CHANNEL_OC1B:
+		if(TIMER_IS_PWM_MODE(a_timerConfig->mode)){
+			OCR1B = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * g_timer1Top)/100);
+			DDRD  |= (1 << OC1B);
+		}
+		else{
+			OCR1B = a_timerConfig->mode_data.ctc_compare_value;
+			SET_BIT(TIMSK,OCIE1B);
+		}
+		TCCR1A = (TCCR1A & ~(0x03 << COM1B0)) | (a_timerConfig->ocx_pin_behavior << COM1B0);
+		break;
+	case TIMER1_CHANNEL_ICP:
+		TIFR = (1 << ICF1);		/*discard any stale capture, a flag is cleared by writing one to it*/
+		SET_BIT(TIMSK,TICIE1);
+		break;
+
+	case TIMER2_CHANNEL_OVF:
+		SET_BIT(TIMSK,TOIE2);
+		break;
+	case TIMER2_CHANNEL_OC2:
+		if(TIMER_IS_PWM_MODE(a_timerConfig->mode)){
+			OCR2 = (((uint16)a_timerConfig->mode_data.pwm_duty_cycle * TIMER2_MAX_COUNT)/100);
+			DDRD  |= (1<<OC2);
+		}
+		else{
+			OCR2 = a_timerConfig->mode_data.ctc_compare_value;
+			SET_BIT(TIMSK,OCIE2);
+		}
+		TCCR2 = (TCCR2 & ~(0x03 << COM20)) | (a_timerConfig->ocx_pin_behavior << COM20);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void TIMER_disableChannel(TIMER_Channel a_channel){
+	switch(a_channel){
+	case TIMER0_CHANNEL_OVF:
+		CLEAR_BIT(TIMSK,TOIE0);
+		break;
+	case TIMER0_CHANNEL_OC0:
+		CLEAR_BIT(TIMSK,OCIE0);
+		TCCR0 &= ~(0x03 << COM00);
+		break;
+	case TIMER1_CHANNEL_OVF:
+		CLEAR_BIT(TIMSK,TOIE1);
+		break;
+	case TIMER1_CHANNEL_OC1A:
+		CLEAR_BIT(TIMSK,OCIE1A);
+		TCCR1A &= ~(0x03 << COM1A0);
+		break;
+	case TIMER1_CHANNEL_OC1B:
+		CLEAR_BIT(TIMSK,OCIE1B);
+		TCCR1A &= ~(0x03 << COM1B0);
+		break;
+	case TIMER1_CHANNEL_ICP:
+		CLEAR_BIT(TIMSK,TICIE1);
+		break;
+	case TIMER2_CHANNEL_OVF:
+		CLEAR_BIT(TIMSK,TOIE2);
+		break;
+	case TIMER2_CHANNEL_OC2:
+		CLEAR_BIT(TIMSK,OCIE2);
+		TCCR2 &= ~(0x03 << COM20);
+		break;
+	default:
+		break;
+	}
+}
+
+void TIMER_deInit(TIMER_ID a_timerId){
 	switch(a_timerId){
 	case TIMER0_ID:
-		g_timer0CallBackPtr = a_functionAddressPtr;
+		TIMER0_deInit();
 		break;
 	case TIMER1_ID:
-		g_timer1CallBackPtr = a_functionAddressPtr;
+		TIMER1_deInit();
 		break;
 	case TIMER2_ID:
-		g_timer2CallBackPtr = a_functionAddressPtr;
+		TIMER2_deInit();
 		break;
 	}
 }
 
+boolean TIMER_subscribe(TIMER_Event a_event, void (*a_callback)(void), uint16 a_divisor){
+	TIMER_Subscriber * table;
+	uint8 i, sreg;
+
+	if(a_event >= TIMER_NUM_OF_EVENTS || a_callback == NULL_PTR || a_divisor == 0){
+		return FALSE;
+	}
+
+	table = g_eventTable[a_event];
+	for(i = 0; i < g_eventCapacity[a_event]; i++){
+		if(table[i].callback == NULL_PTR){
+			/*the ISR must not see a half written entry*/
+			sreg = SREG;
+			cli();
+			table[i].divisor = a_divisor;
+			table[i].countdown = a_divisor;
+			table[i].callback = a_callback;
+			SREG = sreg;
+			return TRUE;
+		}
+	}
+	return FALSE; /*table is full*/
+}
+
+void TIMER_unsubscribe(TIMER_Event a_event, void (*a_callback)(void)){
+	TIMER_Subscriber * table;
+	uint8 i, sreg;
+
+	if(a_event >= TIMER_NUM_OF_EVENTS){
+		return;
+	}
+
+	table = g_eventTable[a_event];
+	for(i = 0; i < g_eventCapacity[a_event]; i++){
+		if(table[i].callback == a_callback){
+			sreg = SREG;
+			cli();
+			table[i].callback = NULL_PTR;
+			SREG = sreg;
+		}
+	}
+}
+
 void TIMER_changeCompareValue(TIMER_ID a_timerId, uint16 a_new_vlaue){
 	switch(a_timerId){
 	case TIMER0_ID:
@@ -132,6 +351,102 @@ void TIMER_changeCompareValue(TIMER_ID a_timerId, uint16 a_new_vlaue){
 	}
 }
 
+void TIMER_changeDutyCount(TIMER_Channel a_channel, uint16 a_count){
+	uint8 sreg;
+
+	switch(a_channel){
+	case TIMER0_CHANNEL_OC0:
+		OCR0 = (uint8)a_count;
+		break;
+	case TIMER1_CHANNEL_OC1A:
+	case TIMER1_CHANNEL_OC1B:
+		/*a 16-bit write goes through the TEMP register shared with the ISRs*/
+		sreg = SREG;
+		cli();
+		if(a_channel == TIMER1_CHANNEL_OC1A){
+			OCR1A = a_count;
+		}
+		else{
+			OCR1B = a_count;
+		}
+		SREG = sreg;
+		break;
+	case TIMER2_CHANNEL_OC2:
+		OCR2 = (uint8)a_count;
+		break;
+	default:
+		break;
+	}
+}
+
+void TIMER_scheduleCompare(TIMER_Channel a_channel, uint16 a_ticks){
+	uint8 sreg = SREG;
+
+	/*the 16-bit accesses go through the TEMP register shared with the ISRs*/
+	cli();
+	/*a flag is cleared by writing one to it: only the flag of the channel is written*/
+	switch(a_channel){
+	case TIMER0_CHANNEL_OC0:
+		OCR0 = (uint8)(TCNT0 + a_ticks);
+		TIFR = (1 << OCF0);
+		break;
+	case TIMER1_CHANNEL_OC1A:
+		OCR1A = TCNT1 + a_ticks;
+		TIFR = (1 << OCF1A);
+		break;
+	case TIMER1_CHANNEL_OC1B:
+		OCR1B = TCNT1 + a_ticks;
+		TIFR = (1 << OCF1B);
+		break;
+	case TIMER2_CHANNEL_OC2:
+		OCR2 = (uint8)(TCNT2 + a_ticks);
+		TIFR = (1 << OCF2);
+		break;
+	default:
+		break;
+	}
+	SREG = sreg;
+}
+
+void TIMER_advanceCompare(TIMER_Channel a_channel, uint16 a_ticks){
+	uint8 sreg = SREG;
+
+	/*
+	 * A match further than a_ticks away was already passed (the ISR came late):
+	 * it would only come after a full wrap of the timer, it is scheduled from the count instead.
+	 */
+	cli();
+	switch(a_channel){
+	case TIMER0_CHANNEL_OC0:
+		OCR0 += (uint8)a_ticks;
+		if((uint8)(OCR0 - TCNT0) > (uint8)a_ticks){
+			OCR0 = (uint8)(TCNT0 + a_ticks);
+		}
+		break;
+	case TIMER1_CHANNEL_OC1A:
+		OCR1A += a_ticks;
+		if((uint16)(OCR1A - TCNT1) > a_ticks){
+			OCR1A = TCNT1 + a_ticks;
+		}
+		break;
+	case TIMER1_CHANNEL_OC1B:
+		OCR1B += a_ticks;
+		if((uint16)(OCR1B - TCNT1) > a_ticks){
+			OCR1B = TCNT1 + a_ticks;
+		}
+		break;
+	case TIMER2_CHANNEL_OC2:
+		OCR2 += (uint8)a_ticks;
+		if((uint8)(OCR2 - TCNT2) > (uint8)a_ticks){
+			OCR2 = (uint8)(TCNT2 + a_ticks);
+		}
+		break;
+	default:
+		break;
+	}
+	SREG = sreg;
+}
+
 void TIMER_changeDutyCycle(TIMER_ConfigType * a_timerConfig){
 	switch(a_timerConfig->timer_id){
 	case TIMER0_ID:
@@ -140,10 +455,10 @@ void TIMER_changeDutyCycle(TIMER_ConfigType * a_timerConfig){
 
 	case TIMER1_ID:
 		if(a_timerConfig->timer1_pwm_pin_select == PIN_OC1A){
-			OCR1A = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * TOP_VALUE)/100);
+			OCR1A = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * g_timer1Top)/100);
 		}
 		else if(a_timerConfig->timer1_pwm_pin_select == PIN_OC1B){
-			OCR1B = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * TOP_VALUE)/100);
+			OCR1B = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * g_timer1Top)/100);
 		}
 		break;
 
@@ -153,90 +468,44 @@ void TIMER_changeDutyCycle(TIMER_ConfigType * a_timerConfig){
 	}
 }
 
-static void TIMER0_init(TIMER_ConfigType * a_timerConfig){
+/*
+ * The base functions only program the waveform generation mode and the clock,
+ * compare output modes and interrupt enables belong to the channels.
+ */
+static void TIMER0_initBase(const TIMER_ConfigType * a_timerConfig){
 	TCNT0 = 0;
 
-	if(a_timerConfig->mode == PWM_MODE){
-		OCR0 = (((uint16)a_timerConfig->mode_data.pwm_duty_cycle * TIMER0_MAX_COUNT)/100);
-		DDRB  = DDRB | (1<<OC0); //set PB3/OC0 as output pin --> pin where the PWM signal is generated from MC.
-	}
-	else{
-		SET_BIT(TCCR0,FOC0);
-	}
-
 	if(a_timerConfig->mode == OVERFLOW_MODE){
-		SET_BIT(TIMSK,TOIE0);
 		TCNT0 = a_timerConfig->mode_data.ovf_initial_value & 0x0F; //Set Timer Initial value
 	}
-	else if(a_timerConfig->mode == COMPARE_MODE){
-		OCR0 = a_timerConfig->mode_data.ctc_compare_value;
-		SET_BIT(TIMSK,OCIE0);
-	}
-
-	TCCR0 = ((a_timerConfig->mode & 0x01) << WGM00) |(a_timerConfig->ocx_pin_behavior << COM00)\
-			| (GET_BIT(a_timerConfig->mode,1)<<WGM01) | ((a_timerConfig->prescaler.timer0 & 0x07) << CS00);
 
+	TCCR0 = ((a_timerConfig->mode & 0x01) << WGM00) | (GET_BIT(a_timerConfig->mode,1)<<WGM01)\
+			| ((a_timerConfig->prescaler.timer0 & 0x07) << CS00);
 }
 
-static void TIMER1_init(TIMER_ConfigType * a_timerConfig){
+static void TIMER1_initBase(const TIMER_ConfigType * a_timerConfig){
 	TCNT1 = 0;
-	ICR1 = TOP_VALUE;
-
-	if(a_timerConfig->mode == PWM_MODE){
-		if(a_timerConfig->timer1_pwm_pin_select == PIN_OC1A){
-			OCR1A = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * TOP_VALUE)/100);
-			TCCR1A |= (a_timerConfig->ocx_pin_behavior << COM1A0);
-			DDRD  |= (1 << OC1A);
-		}
-		else if(a_timerConfig->timer1_pwm_pin_select == PIN_OC1B){
-			OCR1B = (((uint32)a_timerConfig->mode_data.pwm_duty_cycle * TOP_VALUE)/100);
-			TCCR1A |= (a_timerConfig->ocx_pin_behavior << COM1B0);
-			DDRD  |= (1 << OC1B);
-		}
-	}
-	else{
-		SET_BIT(TCCR1A,FOC1A);
-		SET_BIT(TCCR1A,FOC1B);
-	}
+	g_timer1Top = (a_timerConfig->timer1_pwm_top != 0) ? a_timerConfig->timer1_pwm_top : TOP_VALUE;
+	ICR1 = g_timer1Top;
 
 	if(a_timerConfig->mode == OVERFLOW_MODE){
-		SET_BIT(TIMSK,TOIE1);
 		TCNT1 = a_timerConfig->mode_data.ovf_initial_value; //Set Timer Initial value
 	}
-	else if(a_timerConfig->mode == COMPARE_MODE){
-		OCR1A = a_timerConfig->mode_data.ctc_compare_value;
-		SET_BIT(TIMSK,OCIE1A);
-	}
 
-	TCCR1A |= (GET_BIT(a_timerConfig->mode,0) << WGM11);
+	TCCR1A = (GET_BIT(a_timerConfig->mode,0) << WGM11);
 	TCCR1B = (GET_BIT(a_timerConfig->mode,0) << WGM13) | (GET_BIT(a_timerConfig->mode,1) << WGM12)\
 			| ( (a_timerConfig->prescaler.timer1 & 0x07) << CS10);
-
 }
 
-static void TIMER2_init(TIMER_ConfigType * a_timerConfig){
+static void TIMER2_initBase(const TIMER_ConfigType * a_timerConfig){
 	TCNT2 = 0;
 
-	if(a_timerConfig->mode == PWM_MODE){
-		OCR2 = (((uint16)a_timerConfig->mode_data.pwm_duty_cycle * TIMER2_MAX_COUNT)/100);
-		DDRD  |= (1<<OC2);
-	}
-	else{
-		SET_BIT(TCCR2,FOC2);
-	}
-
 	if(a_timerConfig->mode == OVERFLOW_MODE){
-		SET_BIT(TIMSK,TOIE2);
 		TCNT2 = a_timerConfig->mode_data.ovf_initial_value & 0x0F; //Set Timer Initial value
 	}
-	else if(a_timerConfig->mode == COMPARE_MODE){
-		OCR2 = a_timerConfig->mode_data.ctc_compare_value;
-		SET_BIT(TIMSK,OCIE2);
-	}
-
-	TCCR2 = ((a_timerConfig->mode & 0x01) << WGM20) |(a_timerConfig->ocx_pin_behavior << COM20)\
-			| (GET_BIT(a_timerConfig->mode,1)<<WGM21) | ((a_timerConfig->prescaler.timer2 & 0x07) << CS20);
 
+	TCCR2 = ((a_timerConfig->mode & 0x01) << WGM20) | (GET_BIT(a_timerConfig->mode,1)<<WGM21)\
+			| ((a_timerConfig->prescaler.timer2 & 0x07) << CS20);
 }
 
 static void TIMER0_deInit(){
@@ -256,7 +525,8 @@ static void TIMER1_deInit(){
 	ICR1 = 0;
 	CLEAR_BIT(TIMSK,OCIE1A);
 	CLEAR_BIT(TIMSK,OCIE1B);
-	CLEAR_BIT(TIMSK,TOIE0);
+	CLEAR_BIT(TIMSK,TICIE1);
+	CLEAR_BIT(TIMSK,TOIE1);
 }
 
 static void TIMER2_deInit(){
@@ -0,0 +1,59 @@
+/******************************************************************************
+ * [FILE NAME]:     timer_manager.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for Timer resource manager
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef TIMER_MANAGER_H_
+#define TIMER_MANAGER_H_
+
+#include "timer.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*Modules that may own a timer channel*/
+typedef enum{
+	TIMER_CLIENT_NONE, TIMER_CLIENT_SYSTICK, TIMER_CLIENT_PROFILER, TIMER_CLIENT_MOTOR, TIMER_CLIENT_ENCODER,
+	TIMER_CLIENT_BUZZER
+}TIMER_Client;
+
+typedef enum{
+	TIMER_CLAIM_OK,			/*channel is handed out to the client*/
+	TIMER_CLAIM_BUSY,		/*channel is already owned by another client*/
+	TIMER_CLAIM_CONFLICT	/*timer is running with a different mode/pre-scaler*/
+}TIMER_ClaimStatus;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Hand out a timer channel to a client.
+ * 1. If the timer is stopped, its base is configured from the given configuration.
+ * 2. If the timer is already running, the configuration must request the same
+ *    mode and pre-scaler (and TOP for the timer1 PWM modes), otherwise the claim
+ *    is refused and nothing is touched.
+ * 3. The channel itself is then enabled without resetting the running counter.
+ * The bookkeeping is not protected from interrupts: claims and releases are made
+ * from the main context only, never from an ISR (the tick included).
+ */
+TIMER_ClaimStatus TIMER_claimChannel(TIMER_Client a_client, TIMER_Channel a_channel, const TIMER_ConfigType * a_timerConfig);
+
+/*
+ * Description :
+ * Give a channel back. The timer is stopped when its last channel is released.
+ * Releasing a channel owned by another client is ignored.
+ */
+void TIMER_releaseChannel(TIMER_Client a_client, TIMER_Channel a_channel);
+
+/*
+ * Description :
+ * Return the client currently owning the channel (TIMER_CLIENT_NONE if free).
+ */
+TIMER_Client TIMER_getChannelOwner(TIMER_Channel a_channel);
+
+#endif /* TIMER_MANAGER_H_ */
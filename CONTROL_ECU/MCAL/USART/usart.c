@@ -6,6 +6,9 @@
  *******************************************************************************/
 
 #include "usart.h"
+#include "../Timer/profiler.h"
+#include "../Timer/systick.h"
+#include "../Watchdog/watchdog.h"
 
 /*******************************************************************************
  *                     		 Functions Definitions                             *
@@ -85,6 +88,39 @@ uint8 USART_receiveByte(void){
 	return UDR; /*RXC is cleared after reading*/
 }
 
+/*
+ * Description :
+ * Read a received byte if there is one, without waiting.
+ * Returns FALSE when nothing was received.
+ */
+boolean USART_tryReceiveByte(uint8 * const a_data){
+	if(BIT_IS_CLEAR(UCSRA,RXC)){
+		return FALSE;
+	}
+
+	*a_data = UDR; /*RXC is cleared after reading*/
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Wait up to a_timeout_ms for a byte from the other UART device.
+ * The wait is bounded so it checks in with the watchdog, a peer that never answers
+ * ends it with FALSE instead of hanging the ECU.
+ */
+boolean USART_receiveByteFor(uint8 * const a_data, uint16 a_timeout_ms){
+	uint32 start = SYSTICK_getMs();
+
+	while(!USART_tryReceiveByte(a_data)){
+		if((SYSTICK_getMs() - start) >= a_timeout_ms){
+			return FALSE;
+		}
+		WDG_checkIn(WDG_TASK_MAIN);
+	}
+
+	return TRUE;
+}
+
 /*
  * Description :
  * Send the required string through UART to the other UART device.
@@ -106,6 +142,8 @@ void USART_sendString(const uint8 * a_txStrPtr){
 void USART_receiveString(uint8 * const a_rxStrPtr){
 	uint8 i=0;
 
+	PROF_BEGIN(PROF_ID_USART_RECEIVE_STRING);
+
 	/* Receive the whole string until the defined terminator char */
 	do{
 		a_rxStrPtr[i] = USART_receiveByte();
@@ -114,4 +152,33 @@ void USART_receiveString(uint8 * const a_rxStrPtr){
 
 	/*replacing  the retminator character with a null terminator*/
 	a_rxStrPtr[i-1] = '\0';
+
+	PROF_END(PROF_ID_USART_RECEIVE_STRING);
+}
+
+/*
+ * Description :
+ * Receive a string until the terminator symbol into a buffer of a_size bytes,
+ * waiting up to a_timeout_ms for each character. The terminator is replaced
+ * with a null terminator.
+ * Returns FALSE on a timeout or if the string does not fit.
+ */
+boolean USART_receiveStringFor(uint8 * const a_rxStrPtr, uint8 a_size, uint16 a_timeout_ms){
+	uint8 i = 0;
+	boolean received = FALSE;
+
+	PROF_BEGIN(PROF_ID_USART_RECEIVE_STRING);
+
+	while(i < a_size && USART_receiveByteFor(&a_rxStrPtr[i], a_timeout_ms)){
+		if(a_rxStrPtr[i] == USART_TERMINATOR_CHARACTER){
+			a_rxStrPtr[i] = '\0';
+			received = TRUE;
+			break;
+		}
+		i++;
+	}
+
+	PROF_END(PROF_ID_USART_RECEIVE_STRING);
+
+	return received;
 }
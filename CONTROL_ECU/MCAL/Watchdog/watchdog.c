@@ -0,0 +1,87 @@
+/******************************************************************************
+ * [FILE NAME]:     watchdog.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the watchdog supervision service
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include "watchdog.h"
+#include "../Timer/systick.h"
+#include <avr/io.h>
+#include <avr/wdt.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+volatile uint8 g_wdgAlive[WDG_NUM_OF_TASKS];
+
+static uint8 g_wdgResetFlags = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void WDG_supervise(void);
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+void WDG_init(void){
+	uint8 i;
+
+	/*keep the reset flags and clear them for the next reset*/
+	g_wdgResetFlags = MCUCSR & 0x1F;
+	MCUCSR &= ~0x1F;
+
+	for(i = 0; i < WDG_NUM_OF_TASKS; i++){
+		g_wdgAlive[i] = FALSE;
+	}
+
+	wdt_enable(WDTO_2S);
+	SYSTICK_subscribe(WDG_supervise, WDG_SUPERVISION_PERIOD_MS);
+}
+
+WDG_ResetCause WDG_getResetCause(void){
+	if(BIT_IS_SET(g_wdgResetFlags, WDG_WDRF)){
+		return WDG_RESET_WATCHDOG;
+	}
+	else if(BIT_IS_SET(g_wdgResetFlags, WDG_BORF)){
+		return WDG_RESET_BROWN_OUT;
+	}
+	else if(BIT_IS_SET(g_wdgResetFlags, WDG_EXTRF)){
+		return WDG_RESET_EXTERNAL;
+	}
+	else if(BIT_IS_SET(g_wdgResetFlags, WDG_JTRF)){
+		return WDG_RESET_JTAG;
+	}
+	else{
+		return WDG_RESET_POWER_ON;
+	}
+}
+
+uint8 WDG_getResetFlags(void){
+	return g_wdgResetFlags;
+}
+
+/*
+ * Description :
+ * Called from the system tick. The hardware watchdog is kicked only when all
+ * tasks have checked in, a task stuck in a loop makes the MCU reset.
+ * The tick itself stopping also stops the kicks.
+ */
+static void WDG_supervise(void){
+	uint8 i;
+
+	for(i = 0; i < WDG_NUM_OF_TASKS; i++){
+		if(g_wdgAlive[i] == FALSE){
+			return;
+		}
+	}
+
+	wdt_reset();
+	for(i = 0; i < WDG_NUM_OF_TASKS; i++){
+		g_wdgAlive[i] = FALSE;
+	}
+}
@@ -22,25 +22,6 @@ int main()
 			.usart_parity = PARITY_DISABLED
 	};
 
-	/*configure timer0 to control the DC motor*/
-	TIMER_ConfigType timer0_config =
-	{
-			.timer_id = TIMER0_ID,
-			.prescaler.timer0 = TIMER0_F_CPU_64,
-			.mode = PWM_MODE,
-			.ocx_pin_behavior = CLEAR_OCX,
-			.mode_data.pwm_duty_cycle = motor_speed_100,
-	};
-
-	TIMER_ConfigType timer1_config =
-	{
-			.timer_id = TIMER1_ID,
-			.mode = COMPARE_MODE,
-			.mode_data.ctc_compare_value = TIMER1_COMPARE_VALUE_7SEC,
-			.prescaler.timer1 = TIMER1_F_CPU_1024,
-			.ocx_pin_behavior = DISCONNECT_OCX,
-	};
-
 	/*Initialize the TWI/I2C Driver*/
 	TWI_ConfigType twi_config =
 	{
@@ -49,25 +30,49 @@ int main()
 			.twi_bit_rate = 400
 	};
 
-	/*set timer1 call back function*/
-	TIMER_setCallBackFunc(TIMER1_ID, APP_timerTickIncrement);
+	/*soft start and soft stop of the door motor*/
+	MOTION_ConfigType motion_config =
+	{
+			.profile = MOTOR_PROFILE,
+			.accel_time_ms = MOTOR_ACCEL_TIME_MS,
+			.decel_time_ms = MOTOR_DECEL_TIME_MS,
+			.cruise_speed = motor_speed_100,
+			.creep_speed = MOTOR_CREEP_SPEED,
+			.brake_at_end = MOTOR_BRAKE_AT_END
+	};
 
 	/*enable global interrupt bit (I-bit)*/
 	sei();
 
 	/*Peripherals & Modules Initialization*/
-	DcMotor_init();
-	BUZZER_init();
-	TIMER_init(&timer0_config);
+	SYSTICK_init();		/*1 ms tick on timer2*/
+	PROF_init();		/*free-running timer1 for the probes (only when profiling is enabled)*/
+	WDG_init();			/*watchdog supervised from the tick*/
+	DcMotor_init();		/*the motor claims timer0 for its PWM signal*/
+	MOTION_init(&motion_config);	/*motor speed ramps updated from the tick*/
+	CURRENT_init();					/*motor current sampled once per PWM period*/
+	CURRENT_setFaultCallBack(MOTION_abort);
+	POSITION_init();				/*end-stops on INT1/INT2 and encoder on ICP1*/
+	POSITION_setTargetCallBack(MOTION_halt);
+	OBSTACLE_init();				/*beam sensor sampled from the tick while the door closes*/
+	OBSTACLE_setCallBack(MOTION_abort);
+	BUZZER_init();					/*tones on OC1B, sequences stepped from the tick*/
 	TWI_init(&twi_config);
 	USART_init(&uart_config);
 
 	_delay_us(1); /*a small delay to initialize the peripherals*/
 
-	/*Set a new password at the beginning of the program*/
-	APP_changePassword();
+	/*motor off, reset cause saved and door brought back to a known state*/
+	APP_recoverSafeState();
+
+	/*
+	 * No password setup is started here: HMI ECU sends a sync byte after its own boot
+	 * and APP_receiveCommand answers it with CHANGE_PASSWORD_COMMAND. After a reset of
+	 * this ECU alone, HMI ECU resyncs when its next exchange gets no answer.
+	 */
 
 	while(1){
+		WDG_checkIn(WDG_TASK_MAIN);
 
 		/*receive command from HMI ECU*/
 		command = APP_receiveCommand();
@@ -76,14 +81,19 @@ int main()
 		switch(command){
 
 		case OPEN_DOOR_COMMAND:
-			APP_doorOpenSequence(&timer1_config);
+			APP_doorOpenSequence();
 			break;
 		case CHANGE_PASSWORD_COMMAND:
 			APP_changePassword();
 			break;
 		case ALARM_COMMAND:
-			APP_alarmSequence(&timer1_config);
+			APP_alarmSequence();
+			break;
+#if (PROF_ENABLED == 1)
+		case PROFILE_REPORT_COMMAND:
+			PROF_report();	/*read by a terminal on the USART output*/
 			break;
+#endif
 		case NO_COMMAND:
 		default:
 			; /*do nothing*/
@@ -10,10 +10,10 @@
  *                     	   	  Global Variables                                 *
  *******************************************************************************/
 
-/*the  entered password (extra character for the terminator special char)*/
-uint8 g_passwordInput[PASSWORD_LENGTH + 1] = {0};
+/*the  entered password (extra characters for the terminator special char and the null)*/
+uint8 g_passwordInput[PASSWORD_MAX_LENGTH + 2] = {0};
 uint8 g_wrong_passwords = 0;	/*wrong passwords counter*/
-uint8 g_timer1_tick = 0;	/*timer 1 compare match counter*/
+static boolean g_linkLost = FALSE;	/*CONTROL ECU did not answer during an exchange*/
 
 
 /*******************************************************************************
@@ -23,22 +23,34 @@ uint8 g_timer1_tick = 0;	/*timer 1 compare match counter*/
 /*
  * Description:
  * Function that sends a given command to CONTROL ECU
+ * Returns FALSE if the link to CONTROL ECU is lost.
 */
-static void APP_sendCommand(uint8 a_command);
+static boolean APP_sendCommand(uint8 a_command);
 
 /*
  * Description:
- * prompts the user a given instruction on the LCD.
- * get the input from the keypad and store it.
+ * Wait up to LINK_TIMEOUT_MS for a byte from CONTROL ECU, other bytes are dropped.
+ * Returns FALSE and marks the link lost if it does not come.
 */
-static void APP_getPassword(const uint8 const * a_user_prompt);
+static boolean APP_waitForControl(uint8 a_expected);
+
+/*
+ * Description:
+ * prompts the user a given instruction (string id) on the LCD.
+ * get the input from the keypad and store it:
+ * 1- up to PASSWORD_MAX_LENGTH digits, '=' is accepted from PASSWORD_MIN_LENGTH digits.
+ * 2- the backspace key erases the last digit and the clear key all of them.
+ * 3- the digits are erased when no key is pressed for PASSWORD_ENTRY_TIMEOUT.
+*/
+static void APP_getPassword(APP_StringId a_user_prompt);
 
 /*
  * Description:
  * prompts the user to enter the new password and re-enter it to confirm.
  * send both passwords to the CONTROL ECU to be compared and saved.
+ * Returns FALSE if the link to CONTROL ECU is lost.
 */
-static void APP_sendPassword(void);
+static boolean APP_sendPassword(void);
 
 /*
  * Description:
@@ -48,6 +60,69 @@ static void APP_sendPassword(void);
 */
 static APP_PasswordStatus APP_passwordEnquire(void);
 
+/*
+ * Description:
+ * Wait for a given number of milliseconds counted by the system tick.
+*/
+static void APP_waitMs(uint32 a_duration_ms);
+
+/*
+ * Description:
+ * Show the door phases and position reported by CONTROL ECU until the door is closed or left open.
+*/
+static void APP_followDoor(void);
+
+/*
+ * Description:
+ * Wait until the LCD has written everything queued (typing effects included).
+*/
+static void APP_waitLcd(void);
+
+/*
+ * Description:
+ * Info screens opened from the menu, they return on any key.
+*/
+static void APP_showUptime(void);
+static void APP_showFirmware(void);
+static void APP_showWakeLatency(void);
+
+/*
+ * Description:
+ * Hidden screen opened with the admin chord: live keypad matrix state.
+*/
+static void APP_keypadTest(void);
+
+/*******************************************************************************
+ *                                   Menus                                     *
+ *******************************************************************************/
+
+static const APP_MenuItem g_infoMenuItems[] PROGMEM =
+{
+	{STR_MENU_UPTIME,			NULL_PTR,		APP_showUptime,		APP_MENU_NO_RESULT},
+	{STR_MENU_FIRMWARE,			NULL_PTR,		APP_showFirmware,	APP_MENU_NO_RESULT},
+	{STR_MENU_WAKE_LATENCY,		NULL_PTR,		APP_showWakeLatency,	APP_MENU_NO_RESULT}
+};
+
+static const APP_Menu g_infoMenu PROGMEM =
+{
+	STR_MENU_INFO, g_infoMenuItems, sizeof(g_infoMenuItems) / sizeof(APP_MenuItem)
+};
+
+static const APP_MenuItem g_mainMenuItems[] PROGMEM =
+{
+	{STR_MENU_OPEN_DOOR,		NULL_PTR,		NULL_PTR,			DOOR_OPEN},
+	{STR_MENU_CHANGE_PASSWORD,	NULL_PTR,		NULL_PTR,			CHANGE_PASS},
+	{STR_MENU_INFO,				&g_infoMenu,	NULL_PTR,			APP_MENU_NO_RESULT},
+#if (PROF_ENABLED == 1)
+	{STR_MENU_PROFILE,			NULL_PTR,		NULL_PTR,			PROFILE_REPORT}
+#endif
+};
+
+static const APP_Menu g_mainMenu PROGMEM =
+{
+	STR_MENU_MAIN, g_mainMenuItems, sizeof(g_mainMenuItems) / sizeof(APP_MenuItem)
+};
+
 
 /*******************************************************************************
  *                     		 Functions Definitions                             *
@@ -55,42 +130,88 @@ static APP_PasswordStatus APP_passwordEnquire(void);
 
 /*
  * Description:
- * prompts the user a given instruction on the LCD.
- * get the input from the keypad and store it.
+ * prompts the user a given instruction (string id) on the LCD.
+ * get the input from the keypad and store it:
+ * 1- up to PASSWORD_MAX_LENGTH digits, '=' is accepted from PASSWORD_MIN_LENGTH digits.
+ * 2- the backspace key erases the last digit and the clear key all of them.
+ * 3- the digits are erased when no key is pressed for PASSWORD_ENTRY_TIMEOUT.
 */
-static void APP_getPassword(const uint8 const * a_user_prompt)
+static void APP_getPassword(APP_StringId a_user_prompt)
 {
-	uint8 key , i = 0;
-	LCD_displayStringRowColumn(0,0,a_user_prompt);
-
-	LCD_moveCursor(1,13); /* Move the cursor to the second row */
+	uint8 key = 0, i = 0, j;
+	KEYPAD_Event event;
+	boolean received;
+	LCD_bufferClear();
+	LCD_flush(); /*only the cells that differ from the previous screen are written*/
+	LCD_marqueeStartPgm(0, APP_getString(a_user_prompt), MARQUEE_STEP_TIME); /*the prompt scrolls through the first row*/
+
+	LCD_moveCursor(1,PASSWORD_COLUMN); /* Move the cursor to the second row */
 	LCD_sendCommand(LCD_CURSOR_BLINK);
 
-	/*keep getting input until 5 digits are entered.
-	 * eventually, only exit when equal (=) key is pressed on keypad)*/
-	while(i<PASSWORD_LENGTH || key != PASSWORD_ENTER_KEY){
-		key = KEYPAD_getPressedKey();
+	/*keep getting input until the equal (=) key is pressed on keypad with enough digits.
+	 * The digits typed while the screen was drawn wait in the keypad queue.*/
+	while(i<PASSWORD_MIN_LENGTH || key != PASSWORD_ENTER_KEY){
+		if(i == 0)
+		{
+			KEYPAD_waitEvent(&event); /*nothing to lose, the MCU may sleep*/
+			received = TRUE;
+		}
+		else
+		{
+			received = KEYPAD_waitEventFor(&event, PASSWORD_ENTRY_TIMEOUT);
+		}
+
+		if(received == FALSE)
+		{
+			key = KEYPAD_NO_BUTTON;
+		}
+		else if(event.type != KEYPAD_EVENT_PRESSED)
+		{
+			continue; /*holding a key does not repeat a digit*/
+		}
+		else
+		{
+			key = event.key;
+		}
 
 		/*accept numeric inputs only*/
-		if((key <= 9) && (key >= 0) && i<PASSWORD_LENGTH)
+		if((key <= 9) && i<PASSWORD_MAX_LENGTH)
 		{
 			/*store the ascii-code of each number in a global variable*/
 			g_passwordInput[i] = ZERO_ASCII_CODE + key;
 			LCD_characterFade(key + ZERO_ASCII_CODE, PASSWORD_CHARACHER); /* display an asterisk (*) for each digit entered */
 			i++;
 		}
-		_delay_ms(PRESS_TIME); /*delay for button press*/
-
-		/*Turn off the cursor when 5 characters are entered*/
-		if(i==PASSWORD_LENGTH)
+		else if(received == FALSE || key == KEYPAD_KEY_CLEAR)
 		{
-			LCD_sendCommand(LCD_CURSOR_OFF);
+			/*a half typed password is not left in memory*/
+			while(i != 0)
+			{
+				g_passwordInput[--i] = 0;
+			}
+			LCD_moveCursor(1,PASSWORD_COLUMN);
+			for(j = 0; j < PASSWORD_MAX_LENGTH; j++)
+			{
+				LCD_displayCharacter(' ');
+			}
+			LCD_moveCursor(1,PASSWORD_COLUMN);
+		}
+		else if(key == KEYPAD_KEY_BACKSPACE && i != 0)
+		{
+			i--;
+			g_passwordInput[i] = 0;
+			LCD_moveCursor(1,PASSWORD_COLUMN + i);
+			LCD_displayCharacter(' ');
+			LCD_moveCursor(1,PASSWORD_COLUMN + i);
 		}
-	}
 
-	g_passwordInput[5] = USART_TERMINATOR_CHARACTER;  /*A special character denoting the end of a string for UART_send*/
+		/*the cursor is shown while more digits can be entered*/
+		LCD_sendCommand((i == PASSWORD_MAX_LENGTH) ? LCD_CURSOR_OFF : LCD_CURSOR_BLINK);
+	}
+	LCD_sendCommand(LCD_CURSOR_OFF);
 
-	LCD_clearScreen(); /*clear the LCD*/
+	g_passwordInput[i] = USART_TERMINATOR_CHARACTER;  /*A special character denoting the end of a string for UART_send*/
+	g_passwordInput[i + 1] = '\0';
 }
 
 /*
@@ -98,17 +219,46 @@ static void APP_getPassword(const uint8 const * a_user_prompt)
  * prompts the user to enter the new password and re-enter it to confirm.
  * send both passwords to the CONTROL ECU to be compared and saved.
 */
-static void APP_sendPassword(void)
+static boolean APP_sendPassword(void)
 {
 	/*Acknowledge that sender (HMI ECU) is ready to send password value */
 	USART_sendByte(USART_SENDER_READY_BYTE);
 
-	while( USART_receiveByte() != USART_RECEIVER_READY_BYTE)
+	/*wait until the receiver (CONTROL ECU) is ready to receive*/
+	if(!APP_waitForControl(USART_RECEIVER_READY_BYTE))
 	{
-		; /*wait until the receiver (CONTROL ECU) is ready to receive*/
+		return FALSE;
 	}
 
 	USART_sendString(g_passwordInput); /*send the password to receiver (CONTROL ECU)*/
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Wait up to LINK_TIMEOUT_MS for a byte from CONTROL ECU, other bytes are dropped.
+ * Returns FALSE and marks the link lost if it does not come.
+*/
+static boolean APP_waitForControl(uint8 a_expected)
+{
+	uint8 byte;
+	uint32 start = SYSTICK_getMs();
+	uint32 elapsed;
+
+	while(!g_linkLost)
+	{
+		elapsed = SYSTICK_getMs() - start;
+		if(elapsed >= LINK_TIMEOUT_MS || !USART_receiveByteFor(&byte, LINK_TIMEOUT_MS - elapsed))
+		{
+			g_linkLost = TRUE;
+		}
+		else if(byte == a_expected)
+		{
+			return TRUE;
+		}
+	}
+
+	return FALSE;
 }
 
 /*
@@ -124,13 +274,16 @@ static APP_PasswordStatus APP_passwordEnquire(void)
 	/*Acknowledge that receiver (HMI ECU) is ready to receive password compare_result */
 	USART_sendByte(USART_RECEIVER_READY_BYTE);
 
-	while( USART_receiveByte() != USART_SENDER_READY_BYTE)
+	/*wait until the sender (CONTROL) is ready to send password compare_result, then get it*/
+	if(!APP_waitForControl(USART_SENDER_READY_BYTE))
 	{
-		; /*wait until the sender (CONTROL) is ready to send password compare_result  */
+		return PASSWORD_LINK_LOST;
+	}
+	if(!USART_receiveByteFor(&received_compare_result, LINK_TIMEOUT_MS))
+	{
+		g_linkLost = TRUE;
+		return PASSWORD_LINK_LOST;
 	}
-
-	/*get the received status from UART*/
-	received_compare_result = USART_receiveByte();
 
 	/*if the two entered passwords are matching*/
 	if(received_compare_result == MATCHING_PASSWORD_BYTE)
@@ -140,10 +293,11 @@ static APP_PasswordStatus APP_passwordEnquire(void)
 	/*if the two entered passwords are not matching, prompt to the user*/
 	else if (received_compare_result == UNMATCHING_PASSWORD_BYTE && g_wrong_passwords !=3)
 	{
-		LCD_displayStringRowColumn(0,0,"ERROR: Password Does Not Match.");
-		LCD_displayStringRowColumn(1,0,"Please Try Again !");
-		_delay_ms(1000);
-		LCD_clearScreen();
+		LCD_bufferClear();
+		LCD_flush();
+		LCD_marqueeStartPgm(0, APP_getString(STR_PASSWORD_MISMATCH), MARQUEE_STEP_TIME);
+		LCD_marqueeStartPgm(1, APP_getString(STR_TRY_AGAIN), MARQUEE_STEP_TIME);
+		APP_waitMs(1000);
 		return UNMATCHING_PASSWORDS;
 	}
 	else
@@ -154,15 +308,63 @@ static APP_PasswordStatus APP_passwordEnquire(void)
  * Description:
  * Function that sends a given command to CONTROL ECU
 */
-static void APP_sendCommand(uint8 a_command){
+static boolean APP_sendCommand(uint8 a_command){
 	/*Acknowledge that sender (HMI ECU) is ready to send COMMAND*/
 	USART_sendByte(USART_SENDER_READY_BYTE);
 
-	while( USART_receiveByte() != USART_RECEIVER_READY_BYTE){
-		; /*wait until the receiver (CONTROL ECU) is ready to receive the COMMAND*/
+	/*wait until the receiver (CONTROL ECU) is ready to receive the COMMAND*/
+	if(!APP_waitForControl(USART_RECEIVER_READY_BYTE)){
+		return FALSE;
 	}
 
 	USART_sendByte(a_command); /*send a command to signal the door unlocking sequence*/
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Send a sync byte to CONTROL ECU until it replies, dropping anything else received:
+ * LINK_SYNC_BOOT_BYTE after boot, LINK_SYNC_RESUME_BYTE after a lost link.
+ * CONTROL ECU answers from any wait of its exchanges, a wait for the user at once and
+ * another one within its LINK_TIMEOUT_MS. Waiting for it is the healthy state of the watchdog.
+*/
+void APP_syncWithControl(uint8 a_syncByte)
+{
+	uint8 byte;
+	uint32 start;
+	uint32 elapsed;
+	boolean replied = FALSE;
+
+	if(g_linkLost)
+	{
+		LCD_bufferClear();
+		LCD_flush();
+		LCD_marqueeStartPgm(0, APP_getString(STR_LINK_LOST), MARQUEE_STEP_TIME);
+	}
+
+	while(!replied)
+	{
+		USART_sendByte(a_syncByte);
+
+		start = SYSTICK_getMs();
+		while(!replied && (elapsed = SYSTICK_getMs() - start) < LINK_SYNC_RETRY_MS &&
+			  USART_receiveByteFor(&byte, LINK_SYNC_RETRY_MS - elapsed))
+		{
+			replied = (byte == LINK_SYNC_ACK_BYTE);
+		}
+	}
+
+	g_linkLost = FALSE;
+}
+
+/*
+ * Description:
+ * Return TRUE if CONTROL ECU did not answer within LINK_TIMEOUT_MS during an exchange,
+ * until the next APP_syncWithControl.
+*/
+boolean APP_isLinkLost(void)
+{
+	return g_linkLost;
 }
 
 /*
@@ -173,13 +375,14 @@ void APP_welcomeScreen(void)
 {
 	LCD_sendCommand(LCD_CURSOR_BLINK);
 	LCD_moveCursor(0, 3);
-	LCD_writeString("DOOR LOCK SECURITY SYSTEM", SCREEN_WRITE_DELAY);
+	LCD_writeStringPgm(APP_getString(STR_WELCOME), SCREEN_WRITE_DELAY);
 	LCD_moveCursor(1, 10);
-	_delay_ms(750);
-	LCD_writeString("By: Marwan", SCREEN_WRITE_DELAY);
+	APP_waitLcd();
+	APP_waitMs(750);
+	LCD_writeStringPgm(APP_getString(STR_AUTHOR), SCREEN_WRITE_DELAY);
 	LCD_sendCommand(LCD_CURSOR_OFF);
-	_delay_ms(1250);
-	LCD_clearScreen();
+	APP_waitLcd();
+	APP_waitMs(1250);
 }
 
 /*
@@ -196,36 +399,38 @@ void APP_setNewPassword(void)
 	do
 	{
 		/*the new password*/
-		APP_getPassword("Please Enter A New Password:"); 	/*get the password input from user*/
-		APP_sendPassword();
+		APP_getPassword(STR_ENTER_NEW_PASSWORD); 	/*get the password input from user*/
+		if(!APP_sendPassword())
+		{
+			return;	/*link lost*/
+		}
 
 		/*confirm the new password*/
-		APP_getPassword("Please Re-enter The Password:"); 	/*get the password input from user*/
-		APP_sendPassword();
+		APP_getPassword(STR_REENTER_PASSWORD); 	/*get the password input from user*/
+		if(!APP_sendPassword())
+		{
+			return;
+		}
 	}
 	while(APP_passwordEnquire() == UNMATCHING_PASSWORDS);
 }
 
 /*
  * Description:
- * Displays the main menu: prompts the user to make a choice.
+ * Displays the main menu: the user navigates it with the keypad to make a choice.
  * Checks whether the password entered by user is correct or not.
- * returns the choice made by the user.
+ * returns the choice made by the user, NO_CHOICE if the link to CONTROL ECU was lost.
 */
 APP_MainMenuData APP_mainMenu(void)
 {
-	uint8 key;
-	LCD_displayStringRowColumn(0, 0, "(+): Open The Door.");
-	LCD_displayStringRowColumn(1, 0, "(-): Change The Password.");
+	APP_MainMenuData choice;
+	APP_PasswordStatus status;
 
 	/*wait for user to choose whether to open the door or change the password*/
-	do
+	while((choice = APP_menuRun(&g_mainMenu)) == APP_MENU_CHORD_RESULT(ADMIN_CHORD_ID))
 	{
-		key = KEYPAD_getPressedKey();
+		APP_keypadTest();
 	}
-	while(key != '+' && key != '-');
-
-	LCD_clearScreen();
 
 	do
 	{
@@ -234,62 +439,227 @@ APP_MainMenuData APP_mainMenu(void)
 		{
 			return ALARM;
 		}
-		APP_getPassword("Please Enter The Password:");		/*ask the user to enter a password*/
-		APP_sendPassword();								/*send it to CONTROL ECU to be checked*/
+		APP_getPassword(STR_ENTER_PASSWORD);		/*ask the user to enter a password*/
+		status = APP_sendPassword() ? APP_passwordEnquire() : PASSWORD_LINK_LOST;	/*send it to CONTROL ECU to be checked*/
+
+		if(status == PASSWORD_LINK_LOST)
+		{
+			g_wrong_passwords--;	/*CONTROL ECU does not count an attempt it did not answer*/
+			return NO_CHOICE;
 		}
-	while(APP_passwordEnquire() == UNMATCHING_PASSWORDS);
+	}
+	while(status == UNMATCHING_PASSWORDS);
 
 	/*reset the counter if a correct password is entered*/
 	g_wrong_passwords = 0;
 
-	if (key == '-')
-	{
-		return CHANGE_PASS;
+	return choice;
+}
 
+/*
+ * Description:
+ * Show the time since the last reset until a key is pressed,
+ * the tick (so this time) stops while the keypad keeps the MCU in Power-down.
+*/
+static void APP_showUptime(void)
+{
+	uint32 seconds = SYSTICK_getMs() / 1000;
+
+	LCD_bufferClear();
+	LCD_bufferWriteFieldPgm(0, 0, APP_getString(STR_MENU_UPTIME), LCD_NUM_OF_COLS);
+
+	/*"hhhh:mm:ss"*/
+	LCD_bufferWriteUnsigned(1, 0, (uint16)(seconds / 3600), 4, ' ');
+	LCD_bufferWriteCharacter(1, 4, ':');
+	LCD_bufferWriteUnsigned(1, 5, (seconds / 60) % 60, 2, '0');
+	LCD_bufferWriteCharacter(1, 7, ':');
+	LCD_bufferWriteUnsigned(1, 8, seconds % 60, 2, '0');
+
+	LCD_bufferWriteFieldPgm(3, 0, APP_getString(STR_PRESS_ANY_KEY), LCD_NUM_OF_COLS);
+	LCD_flush();
+
+	KEYPAD_getPressedKey();
+}
+
+/*
+ * Description:
+ * Show the firmware version until a key is pressed.
+*/
+static void APP_showFirmware(void)
+{
+	LCD_bufferClear();
+	LCD_bufferWriteFieldPgm(0, 0, APP_getString(STR_MENU_FIRMWARE), LCD_NUM_OF_COLS);
+	LCD_bufferWriteFieldPgm(1, 0, APP_getString(STR_FIRMWARE_VERSION), LCD_NUM_OF_COLS);
+	LCD_bufferWriteFieldPgm(3, 0, APP_getString(STR_PRESS_ANY_KEY), LCD_NUM_OF_COLS);
+	LCD_flush();
+
+	KEYPAD_getPressedKey();
+}
+
+/*
+ * Description:
+ * Show the time from the last keypad wake-up to the key that caused it until a key is pressed.
+*/
+static void APP_showWakeLatency(void)
+{
+	uint16 latency = KEYPAD_getWakeLatency();
+	uint8 width;
+
+	LCD_bufferClear();
+	LCD_bufferWriteFieldPgm(0, 0, APP_getString(STR_MENU_WAKE_LATENCY), LCD_NUM_OF_COLS);
+
+	if(latency == KEYPAD_NO_LATENCY)
+	{
+		LCD_bufferWriteCharacter(1, 0, '-');
 	}
 	else
 	{
-		return DOOR_OPEN;
+		/*"nn ms"*/
+		width = LCD_bufferWriteUnsigned(1, 0, latency, 0, ' ');
+		LCD_bufferWriteFieldPgm(1, width, (const uint8 *)PSTR(" ms"), 3);
+	}
+
+	LCD_bufferWriteFieldPgm(3, 0, APP_getString(STR_PRESS_ANY_KEY), LCD_NUM_OF_COLS);
+	LCD_flush();
+
+	KEYPAD_getPressedKey();
+}
+
+/*
+ * Description:
+ * Hidden screen opened with the admin chord, left with the same chord:
+ * the raw and debounced matrix bitmaps (bit (row * 4 + col)) and the ghosting flag.
+*/
+static void APP_keypadTest(void)
+{
+	KEYPAD_Event event;
+
+	LCD_bufferClear();
+	LCD_bufferWriteFieldPgm(0, 0, APP_getString(STR_KEYPAD_TEST), LCD_NUM_OF_COLS);
+	LCD_bufferWriteFieldPgm(1, 0, APP_getString(STR_KEYPAD_RAW), 5);
+	LCD_bufferWriteFieldPgm(2, 0, APP_getString(STR_KEYPAD_KEYS), 5);
+
+	while(1)
+	{
+		LCD_bufferWriteHex(1, 5, KEYPAD_getRawState(), 4);
+		LCD_bufferWriteHex(2, 5, KEYPAD_getState(), 4);
+		LCD_bufferWriteFieldPgm(3, 0, KEYPAD_isGhosting() ? APP_getString(STR_KEYPAD_GHOSTING) : (const uint8 *)PSTR(""), LCD_NUM_OF_COLS);
+		LCD_flush(); /*only the changed digits are written*/
+
+		while(KEYPAD_waitEventFor(&event, KEYPAD_TEST_REFRESH_TIME))
+		{
+			if(event.type == KEYPAD_EVENT_CHORD && event.key == ADMIN_CHORD_ID)
+			{
+				return;
+			}
+		}
 	}
 }
 
 /*
- * Description :
- * Callback function  that increments a global variable g_timer1_tick
- */
-void APP_timerTickIncrement(void)
+ * Description:
+ * Wait for a given number of milliseconds counted by the system tick.
+*/
+static void APP_waitMs(uint32 a_duration_ms)
 {
-	g_timer1_tick++;
+	uint32 start = SYSTICK_getMs();
+
+	while((SYSTICK_getMs() - start) < a_duration_ms)
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+	}
+}
+
+/*
+ * Description:
+ * Wait until the LCD has written everything queued (typing effects included).
+*/
+static void APP_waitLcd(void)
+{
+	while(!LCD_isIdle())
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+	}
 }
 
 /*
  * Description:
  * Sequence of steps that HMI_ECU does when opening the door:
  * 1- Send the door open command command to CONTROL ECU.
- * 2- Display the door status on LCD.
+ * 2- Display the door status and position reported by CONTROL ECU on LCD.
 */
-void APP_doorOpenSequence(TIMER_ConfigType * const a_timer1_config)
+void APP_doorOpenSequence(void)
 {
-	APP_sendCommand(OPEN_DOOR_COMMAND);
-
-	/*Display the door status on LCD*/
-	/*Display the door opening string for 15 seconds*/
-	LCD_displayStringRowColumn(0, 0, "The Door is Opening...");
-	a_timer1_config->timer_mode_data.ctc_compare_value = TIMER1_COMPARE_VALUE_7SEC;
-	TIMER_init(a_timer1_config);
-	while(g_timer1_tick < 2);
-
-	/*Display the door is opened for 3 seconds*/
-	LCD_displayStringRowColumn(0, 0, "The Door is Opened !  ");
-	TIMER_changeCompareValue(TIMER1_ID, TIMER1_COMPARE_VALUE_3SEC);
-	while(g_timer1_tick < 3);
-
-	/*Display the door closing string for 15 seconds*/
-	LCD_displayStringRowColumn(0, 0, "The Door is Closing...");
-	TIMER_changeCompareValue(TIMER1_ID, TIMER1_COMPARE_VALUE_7SEC);
-	while(g_timer1_tick < 5);
-	TIMER_deInit(TIMER1_ID);
-	g_timer1_tick = 0;
+	if(!APP_sendCommand(OPEN_DOOR_COMMAND))
+	{
+		return;
+	}
+
+	/*Display the door status on the first row and the door position on the second one*/
+	LCD_bufferClear();
+	LCD_bufferProgressBar(1, 0, LCD_NUM_OF_COLS, 0);
+	LCD_flush();
+
+	APP_followDoor();
+}
+
+/*
+ * Description:
+ * Show the door phases and position reported by CONTROL ECU until the door is closed or left open:
+ * a phase byte restarts the marquee of the first row, a position byte (0 to 100)
+ * moves the progress bar, only the cell whose fill changed is written.
+ * An obstacle that reversed the door is kept on the third row until the door is closed.
+*/
+static void APP_followDoor(void)
+{
+	uint8 report;
+	uint32 last_report = SYSTICK_getMs();
+
+	while((SYSTICK_getMs() - last_report) < DOOR_REPORT_TIMEOUT)
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+
+		if(USART_tryReceiveByte(&report) == FALSE)
+		{
+			continue;
+		}
+		last_report = SYSTICK_getMs();
+
+		if(report & DOOR_PHASE_MARKER)
+		{
+			switch(report & ~DOOR_PHASE_MARKER)
+			{
+			case DOOR_PHASE_OPENING:
+				LCD_marqueeStartPgm(0, APP_getString(STR_DOOR_OPENING), MARQUEE_STEP_TIME);
+				break;
+			case DOOR_PHASE_OPEN:
+				LCD_marqueeStartPgm(0, APP_getString(STR_DOOR_OPENED), MARQUEE_STEP_TIME);
+				break;
+			case DOOR_PHASE_CLOSING:
+				LCD_marqueeStartPgm(0, APP_getString(STR_DOOR_CLOSING), MARQUEE_STEP_TIME);
+				break;
+			case DOOR_PHASE_OBSTACLE:
+				LCD_marqueeStartPgm(2, APP_getString(STR_DOOR_OBSTACLE), MARQUEE_STEP_TIME);
+				break;
+			case DOOR_PHASE_HELD_OPEN:
+				LCD_marqueeStartPgm(0, APP_getString(STR_DOOR_HELD_OPEN), MARQUEE_STEP_TIME);
+				APP_waitMs(DOOR_HELD_OPEN_TIME);
+				return;
+			case DOOR_PHASE_JAMMED:
+				LCD_marqueeStartPgm(0, APP_getString(STR_DOOR_JAMMED), MARQUEE_STEP_TIME);
+				APP_waitMs(DOOR_HELD_OPEN_TIME);
+				return;
+			case DOOR_PHASE_CLOSED:
+			default:
+				return;
+			}
+		}
+		else
+		{
+			LCD_bufferProgressBar(1, 0, LCD_NUM_OF_COLS, report);
+			LCD_flush();
+		}
+	}
 }
 
 /*
@@ -299,11 +669,19 @@ void APP_doorOpenSequence(TIMER_ConfigType * const a_timer1_config)
 */
 void APP_changePasswordSequence()
 {
-	APP_sendCommand(CHANGE_PASSWORD_COMMAND); /*send command to CONTROL ECU*/
+	if(!APP_sendCommand(CHANGE_PASSWORD_COMMAND)) /*send command to CONTROL ECU*/
+	{
+		return;
+	}
 	APP_setNewPassword(); /*get password and confirmation*/
-	LCD_displayStringRowColumn(0, 0, "The New Password Is Now Active:)");
-	_delay_ms(1500);
-	LCD_clearScreen();
+	if(g_linkLost)
+	{
+		return;	/*the old password stays in use*/
+	}
+	LCD_bufferClear();
+	LCD_flush();
+	LCD_marqueeStartPgm(0, APP_getString(STR_PASSWORD_ACTIVE), MARQUEE_STEP_TIME);
+	APP_waitMs(1500);
 }
 
 /*
@@ -311,22 +689,90 @@ void APP_changePasswordSequence()
  * Sequence of steps that HMI_ECU does when an alarm is triggered.
  * It's executed when the global wrong password counter is 3.
 */
-void APP_alarmSequence(TIMER_ConfigType * const a_timer1_config)
+void APP_alarmSequence(void)
 {
+	uint32 start;
+	uint32 elapsed = 0;
+	uint8 remaining_seconds;
+	uint8 shown_seconds = 0;
+
 	g_wrong_passwords = 0;/*reset wrong passwords global counter*/
 
 	/*display error message on LCD screen*/
+	LCD_bufferClear();
+	LCD_bufferWriteCharacter(2, 2, 's');
+	LCD_flush();
+	LCD_marqueeStartPgm(0, APP_getString(STR_TOO_MANY_ATTEMPTS), MARQUEE_STEP_TIME);
+	LCD_marqueeStartPgm(1, APP_getString(STR_DOOR_LOCKED), MARQUEE_STEP_TIME);
+
+	/*display the message for 1 minute, counting the remaining seconds down on the third row*/
+	start = SYSTICK_getMs();
+	while(elapsed < ALARM_TIME)
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+
+		remaining_seconds = (uint8)((ALARM_TIME - elapsed + 999) / 1000);
+		if(remaining_seconds != shown_seconds)
+		{
+			LCD_bufferWriteUnsigned(2, 0, remaining_seconds, 2, ' ');
+			LCD_flush();
+			shown_seconds = remaining_seconds;
+		}
+
+		elapsed = SYSTICK_getMs() - start;
+	}
+
+	KEYPAD_flush(); /*the keypad was locked, nothing typed meanwhile is used*/
+}
+
+#if (PROF_ENABLED == 1)
+/*
+ * Description:
+ * Write full 16-character lines and clear the screen a number of times, then
+ * send the LCD probes through the USART: the string, character and command
+ * probes time the queueing, the service probe the writes done by the tick and
+ * the transfer probe one byte on the bus (build with LCD_DATA_BITS_MODE 4 and 8
+ * to compare the two wirings).
+ * */
+void APP_lcdBenchmark(void)
+{
+	uint8 i;
+
+	for(i = 0; i < LCD_BENCHMARK_LINES; i++)
+	{
+		LCD_moveCursor(i & 0x01, 0);
+		LCD_displayStringPgm(APP_getString(STR_BENCHMARK_LINE));
+		WDG_checkIn(WDG_TASK_MAIN);
+	}
 	LCD_clearScreen();
-	LCD_displayStringRowColumn(0, 0, "ERROR: TOO MANY ATTEMPTS !");
-	LCD_displayStringRowColumn(1, 0, "DOOR IS LOCKED FOR 1 MIN..");
-
-	/*display the message for 1 minute via timer 1*/
-	a_timer1_config->timer_mode_data.ctc_compare_value = TIMER1_COMPARE_VALUE_7SEC;
-	TIMER_init(a_timer1_config);
-	while(g_timer1_tick < 8);
-
-	LCD_clearScreen(); /*clear the screen*/
-	/*de-initialize timer 1*/
-	g_timer1_tick = 0;
-	TIMER_deInit(TIMER1_ID);
+	APP_waitLcd();	/*the service probe covers the actual bus writes*/
+
+	PROF_report();
+}
+
+/*
+ * Description:
+ * Ask CONTROL ECU for its profiler report, read on its USART output by a terminal,
+ * the bytes of the report reaching HMI ECU are dropped.
+ * */
+void APP_profileReportSequence(void)
+{
+	uint8 byte;
+	uint32 last_byte;
+
+	if(!APP_sendCommand(PROFILE_REPORT_COMMAND))
+	{
+		return;
+	}
+
+	last_byte = SYSTICK_getMs();
+	while((SYSTICK_getMs() - last_byte) < PROFILE_REPORT_QUIET_MS)
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+		if(USART_tryReceiveByte(&byte))
+		{
+			last_byte = SYSTICK_getMs();
+		}
+	}
 }
+#endif
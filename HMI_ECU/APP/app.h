@@ -7,30 +7,50 @@
 #ifndef APP_APP_H_
 #define APP_APP_H_
 
+#include "app_strings.h"
+#include "app_menu.h"
 #include "../HAL/LCD/lcd.h"
+#include "../HAL/LCD/lcd_format.h"
 #include "../HAL/Keypad/keypad.h"
 #include "../MCAL/USART/usart.h"
-#include "../MCAL/Timer/timer.h"
+#include "../MCAL/Timer/systick.h"
+#include "../MCAL/Timer/profiler.h"
+#include "../MCAL/Watchdog/watchdog.h"
 #include <util/delay.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
 
-#define PASSWORD_LENGTH 			5		/*the exact number of digits that a user must enter*/
+#define PASSWORD_MIN_LENGTH			4		/*digits needed before the password can be entered*/
+#define PASSWORD_MAX_LENGTH			8		/*digits accepted, must match CONTROL ECU*/
+#define PASSWORD_ENTRY_TIMEOUT		15000	/*time in ms without a key after which the typed digits are erased*/
+#define PASSWORD_COLUMN				(LCD_NUM_OF_COLS - PASSWORD_MAX_LENGTH)	/*first cell of the digits on the second row*/
 #define PASSWORD_ENTER_KEY			'='		/*the key used to enter the password*/
 #define MATCHING_PASSWORD_BYTE		0xFF	/*byte received from CONTROL ECU when password is matching*/
 #define UNMATCHING_PASSWORD_BYTE	0x00	/*byte received from CONTROL ECU when password not matching*/
 #define ZERO_ASCII_CODE				48 		/*ascii-code of number 0*/
-#define PRESS_TIME					150
-#define MOTOR_ROTATION_DELAY		15000	/*time taken for the motor to open/close the door*/
-#define DOOR_OPEN_TIME				3000	/*time for which the door is left open*/
+#define DOOR_PROGRESS_MAX			100		/*door position received from CONTROL ECU: 0 closed, 100 open*/
+#define DOOR_PHASE_MARKER			0x80	/*set in the bytes reporting a new phase (APP_DoorPhase) of the door*/
+#define DOOR_REPORT_TIMEOUT			5000	/*the door screen is left if CONTROL ECU stays silent longer*/
+#define DOOR_HELD_OPEN_TIME			3000	/*time for which the door left open (or jammed) is shown*/
+#define LINK_SYNC_BOOT_BYTE			0xA5	/*sent after boot: CONTROL ECU drops its exchange and expects a new password*/
+#define LINK_SYNC_RESUME_BYTE		0xA6	/*sent after a lost link: CONTROL ECU drops its exchange*/
+#define LINK_SYNC_ACK_BYTE			0x5A	/*reply of CONTROL ECU to a sync byte*/
+#define LINK_SYNC_RETRY_MS			200		/*a sync byte without reply is sent again after this time*/
+#define LINK_TIMEOUT_MS				1000	/*longest wait for CONTROL ECU inside an exchange*/
+#define ALARM_TIME					60000	/*time for which the keypad is locked*/
 #define MAX_WRONG_PASSWORDS			3		/*Allowed number of wrong passwords before alarm triggers*/
-#define TIMER1_COMPARE_VALUE_7SEC	58594	/*compare value for timer1 to tick every 7.5 seconds*/
-#define TIMER1_COMPARE_VALUE_3SEC	23438	/*compare value for timer1 to tick every 3 seconds*/
 #define SCREEN_WRITE_DELAY			40
+#define MARQUEE_STEP_TIME			300		/*time in ms between two steps of a scrolling message*/
 #define PASSWORD_CHARACHER			'*'
+#define ADMIN_CHORD_ID				0		/*hidden keypad test opened from the main menu*/
+#define ADMIN_CHORD					(KEYPAD_BUTTON_MASK(4) | KEYPAD_BUTTON_MASK(13))	/*'/' and the unlabeled button together*/
+#define KEYPAD_TEST_REFRESH_TIME	50		/*time in ms between two readings of the keypad test*/
+#define LCD_BENCHMARK_LINES			20		/*number of full lines written by the LCD benchmark*/
+#define PROFILE_REPORT_QUIET_MS		100		/*the profiler report of CONTROL ECU is over once the link is quiet for this time*/
 
 /*******************************************************************************
  *                               Types Declaration                             *
@@ -38,18 +58,25 @@
 
 typedef enum
 {
-	CHANGE_PASS, DOOR_OPEN, ALARM
+	CHANGE_PASS, DOOR_OPEN, ALARM, PROFILE_REPORT, NO_CHOICE
 }APP_MainMenuData;
 
 typedef enum{
-	MATCHING_PASSWORDS, UNMATCHING_PASSWORDS
+	MATCHING_PASSWORDS, UNMATCHING_PASSWORDS, PASSWORD_LINK_LOST
 }APP_PasswordStatus;
 
+/*phases of the door sequence reported by CONTROL ECU (same values as its APP_DoorState)*/
+typedef enum{
+	DOOR_PHASE_CLOSED, DOOR_PHASE_OPENING, DOOR_PHASE_OPEN, DOOR_PHASE_CLOSING, DOOR_PHASE_OBSTACLE,
+	DOOR_PHASE_HELD_OPEN, DOOR_PHASE_JAMMED
+}APP_DoorPhase;
+
 typedef enum{
 	NO_COMMAND,						/*No command was sent to CONTROL ECU*/
 	OPEN_DOOR_COMMAND = 0x10,		/*Command sent to CONTROL ECU to open the door*/
 	CHANGE_PASSWORD_COMMAND = 0x11,	/*Command sent to CONTROL ECU to change the password*/
-	ALARM_COMMAND = 0x12			/*Command when alarm is to be triggered*/
+	ALARM_COMMAND = 0x12,			/*Command when alarm is to be triggered*/
+	PROFILE_REPORT_COMMAND = 0x13	/*Debug command: CONTROL ECU sends its profiler report (profiling builds)*/
 }APP_Commands;
 
 
@@ -69,6 +96,21 @@ extern uint8 g_wrong_passwords;
  * */
 void APP_welcomeScreen(void);
 
+/*
+ * Description:
+ * Send a sync byte to CONTROL ECU until it replies, dropping anything else received:
+ * LINK_SYNC_BOOT_BYTE after boot, LINK_SYNC_RESUME_BYTE after a lost link.
+ * Both ECUs then start from a known point of the protocol.
+ * */
+void APP_syncWithControl(uint8 a_syncByte);
+
+/*
+ * Description:
+ * Return TRUE if CONTROL ECU did not answer within LINK_TIMEOUT_MS during an exchange,
+ * until the next APP_syncWithControl.
+ * */
+boolean APP_isLinkLost(void);
+
 /*
  * Description:
  * A function that sets a new password.
@@ -81,9 +123,9 @@ void APP_setNewPassword(void);
 
 /*
  * Description:
- * Displays the main menu: prompts the user to make a choice.
+ * Displays the main menu: the user navigates it with the keypad to make a choice.
  * Checks whether the password entered by user is correct or not.
- * returns the choice made by the user.
+ * returns the choice made by the user, NO_CHOICE if the link to CONTROL ECU was lost.
  * */
 APP_MainMenuData APP_mainMenu(void);
 
@@ -91,9 +133,9 @@ APP_MainMenuData APP_mainMenu(void);
  * Description:
  * Sequence of steps that HMI_ECU does when opening the door:
  * 1- Send the door open command command to CONTROL ECU.
- * 2- Display the door status on LCD.
+ * 2- Display the door status and position reported by CONTROL ECU on LCD.
  * */
-void APP_doorOpenSequence(TIMER_ConfigType * const a_timer1_config);
+void APP_doorOpenSequence(void);
 
 /*
  * Description:
@@ -109,12 +151,23 @@ void APP_changePasswordSequence();
  * 2- display error message on LCD screen.
  * 3- Do Not receive any input for 1 minute.
  * */
-void APP_alarmSequence(TIMER_ConfigType * const a_timer1_config);
+void APP_alarmSequence(void);
+
+#if (PROF_ENABLED == 1)
+/*
+ * Description:
+ * Write full 16-character lines and clear the screen a number of times, then
+ * send the LCD probes through the USART: the string, character and command
+ * probes time the queueing, the service probe the writes done by the tick.
+ * */
+void APP_lcdBenchmark(void);
 
 /*
- * Description :
- * Callback function  that increments a global variable g_timer1_tick
- */
-void APP_timerTickIncrement(void);
+ * Description:
+ * Ask CONTROL ECU for its profiler report, read on its USART output by a terminal,
+ * the bytes of the report reaching HMI ECU are dropped.
+ * */
+void APP_profileReportSequence(void);
+#endif
 
 #endif /* APP_APP_H_ */
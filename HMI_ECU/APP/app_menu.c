@@ -0,0 +1,177 @@
+/******************************************************************************
+ * [FILE NAME]:     app_menu.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the menus of the Door lock Application (HMI ECU)
+ *******************************************************************************/
+
+#include "app_menu.h"
+#include "../HAL/LCD/lcd.h"
+#include "../HAL/Keypad/keypad.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Draw a menu with the selected item visible and flush the screen.
+*/
+static void APP_menuDraw(const APP_Menu * a_menu, uint8 a_selected, uint8 * a_top);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Show a menu and navigate it with the keypad until an item with a result is selected:
+ * (+) next item, (-) previous item (both repeat while held), (=) select,
+ * (*) back to the parent menu or to the first menu when held,
+ * a digit selects the item with that number.
+ * Returns the result of the selected item, or APP_MENU_CHORD_RESULT(id) for a keypad chord.
+*/
+uint8 APP_menuRun(const APP_Menu * a_menu)
+{
+	const APP_Menu * stack[APP_MENU_MAX_DEPTH];
+	uint8 depth = 0;
+	uint8 selected = 0;
+	uint8 top = 0;
+	uint8 key;
+	KEYPAD_Event event;
+	APP_Menu menu;
+	APP_MenuItem item;
+
+	/*the menu takes the whole screen*/
+	LCD_bufferClear();
+
+	while(1)
+	{
+		memcpy_P(&menu, a_menu, sizeof(menu));
+		APP_menuDraw(&menu, selected, &top);
+
+		KEYPAD_waitEvent(&event);
+		key = event.key;
+
+		if(event.type == KEYPAD_EVENT_CHORD)
+		{
+			return APP_MENU_CHORD_RESULT(key);
+		}
+		else if(event.type == KEYPAD_EVENT_LONG_PRESS && key == APP_MENU_KEY_BACK)
+		{
+			/*holding back leaves all the submenus*/
+			if(depth != 0)
+			{
+				a_menu = stack[0];
+				depth = 0;
+				selected = 0;
+				top = 0;
+			}
+			continue;
+		}
+		else if(event.type == KEYPAD_EVENT_RELEASED ||
+				(event.type != KEYPAD_EVENT_PRESSED && key != APP_MENU_KEY_NEXT && key != APP_MENU_KEY_PREVIOUS))
+		{
+			continue; /*only the navigation keys repeat while held*/
+		}
+
+		if(key == APP_MENU_KEY_NEXT)
+		{
+			selected = (selected + 1 < menu.count) ? selected + 1 : 0;
+			continue;
+		}
+		else if(key == APP_MENU_KEY_PREVIOUS)
+		{
+			selected = (selected != 0) ? selected - 1 : menu.count - 1;
+			continue;
+		}
+		else if(key == APP_MENU_KEY_BACK)
+		{
+			if(depth != 0)
+			{
+				a_menu = stack[--depth];
+				selected = 0;
+				top = 0;
+			}
+			continue;
+		}
+		else if(key >= 1 && key <= 9 && key <= menu.count)
+		{
+			selected = key - 1;
+		}
+		else if(key != APP_MENU_KEY_SELECT)
+		{
+			continue;
+		}
+
+		memcpy_P(&item, &menu.items[selected], sizeof(item));
+
+		if(item.submenu != NULL_PTR && depth < APP_MENU_MAX_DEPTH)
+		{
+			stack[depth++] = a_menu;
+			a_menu = item.submenu;
+			selected = 0;
+			top = 0;
+			continue;
+		}
+		if(item.callback != NULL_PTR)
+		{
+			item.callback();
+			LCD_bufferClear(); /*the callback may have left marquees running*/
+		}
+		if(item.result != APP_MENU_NO_RESULT)
+		{
+			return item.result;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Draw a menu (copied from flash) in the shadow buffer and flush it: the title on the
+ * first row, a window of items on the other rows with the selected one marked by '>'
+ * and '^'/'v' in the last column when more items are above/below.
+*/
+static void APP_menuDraw(const APP_Menu * a_menu, uint8 a_selected, uint8 * a_top)
+{
+	APP_MenuItem item;
+	uint8 row;
+	uint8 index;
+
+	/*scroll the window so the selected item is visible*/
+	if(a_selected < *a_top)
+	{
+		*a_top = a_selected;
+	}
+	else if(a_selected >= *a_top + APP_MENU_VISIBLE_ITEMS)
+	{
+		*a_top = a_selected - APP_MENU_VISIBLE_ITEMS + 1;
+	}
+
+	LCD_bufferWriteFieldPgm(0, 0, APP_getString(a_menu->title), LCD_NUM_OF_COLS);
+
+	for(row = 1; row <= APP_MENU_VISIBLE_ITEMS; row++)
+	{
+		index = *a_top + row - 1;
+		if(index < a_menu->count)
+		{
+			memcpy_P(&item, &a_menu->items[index], sizeof(item));
+
+			/*">1.Label" with the item number used by the digit keys*/
+			LCD_bufferWriteCharacter(row, 0, (index == a_selected) ? '>' : ' ');
+			LCD_bufferWriteCharacter(row, 1, (index < 9) ? '1' + index : ' ');
+			LCD_bufferWriteCharacter(row, 2, (index < 9) ? '.' : ' ');
+			LCD_bufferWriteFieldPgm(row, 3, APP_getString(item.label), LCD_NUM_OF_COLS - 4);
+		}
+		else
+		{
+			LCD_bufferWriteFieldPgm(row, 0, (const uint8 *)PSTR(""), LCD_NUM_OF_COLS - 1);
+		}
+	}
+
+	LCD_bufferWriteCharacter(1, LCD_NUM_OF_COLS - 1, (*a_top != 0) ? '^' : ' ');
+	LCD_bufferWriteCharacter(APP_MENU_VISIBLE_ITEMS, LCD_NUM_OF_COLS - 1, (*a_top + APP_MENU_VISIBLE_ITEMS < a_menu->count) ? 'v' : ' ');
+	LCD_bufferWriteCharacter(2, LCD_NUM_OF_COLS - 1, ' ');
+
+	LCD_flush();
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * [FILE NAME]:     app_menu.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the menus of the Door lock Application (HMI ECU)
+ *******************************************************************************/
+
+#ifndef APP_APP_MENU_H_
+#define APP_APP_MENU_H_
+
+#include "app_strings.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*keypad navigation, a digit key selects the item with that number*/
+#define APP_MENU_KEY_NEXT			'+'
+#define APP_MENU_KEY_PREVIOUS		'-'
+#define APP_MENU_KEY_SELECT			'='
+#define APP_MENU_KEY_BACK			'*'
+
+#define APP_MENU_VISIBLE_ITEMS		3		/*rows 1 to 3, the title is on row 0*/
+#define APP_MENU_MAX_DEPTH			4		/*nested menus kept for the back key*/
+#define APP_MENU_NO_RESULT			0xFF	/*item result that keeps the menu open*/
+#define APP_MENU_CHORD_RESULT(id)	(0xF0 + (id))	/*result of a keypad chord pressed in the menu*/
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+struct APP_MenuStruct;
+
+/*
+ * One line of a menu, selecting it:
+ * 1- opens the submenu if there is one.
+ * 2- runs the callback if there is one, then the menu is shown again.
+ * 3- leaves the menu with the result if it is not APP_MENU_NO_RESULT.
+ */
+typedef struct{
+	APP_StringId label;
+	const struct APP_MenuStruct * submenu;
+	void (*callback)(void);
+	uint8 result;
+}APP_MenuItem;
+
+/*menus and items are const tables in flash (PROGMEM)*/
+typedef struct APP_MenuStruct{
+	APP_StringId title;
+	const APP_MenuItem * items;
+	uint8 count;
+}APP_Menu;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Show a menu and navigate it with the keypad until an item with a result is selected.
+ * The screen is redrawn in the shadow buffer at each key, only the changed cells are written.
+ * Returns the result of the selected item, or APP_MENU_CHORD_RESULT(id) for a keypad chord.
+ * */
+uint8 APP_menuRun(const APP_Menu * a_menu);
+
+#endif /* APP_APP_MENU_H_ */
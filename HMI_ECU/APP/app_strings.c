@@ -0,0 +1,36 @@
+/******************************************************************************
+ * [FILE NAME]:     app_strings.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the UI strings of the Door lock Application (HMI ECU)
+ *******************************************************************************/
+
+#include "app_strings.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                     	   	  Global Variables                                 *
+ *******************************************************************************/
+
+/*every string in flash, nothing is copied to SRAM at startup*/
+#define APP_STRING_TEXT(ID, TEXT)	static const uint8 g_string_##ID[] PROGMEM = TEXT;
+APP_STRING_LIST(APP_STRING_TEXT)
+
+/*table of the strings addresses indexed by id, in flash as well*/
+#define APP_STRING_ENTRY(ID, TEXT)	g_string_##ID,
+static const uint8 * const g_appStrings[APP_NUM_OF_STRINGS] PROGMEM =
+{
+	APP_STRING_LIST(APP_STRING_ENTRY)
+};
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Return the flash address of a string, to be passed to the LCD *Pgm functions.
+ * */
+const uint8 * APP_getString(APP_StringId a_id)
+{
+	return (const uint8 *)pgm_read_word(&g_appStrings[a_id]);
+}
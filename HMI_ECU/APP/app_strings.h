@@ -0,0 +1,78 @@
+/******************************************************************************
+ * [FILE NAME]:     app_strings.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the UI strings of the Door lock Application (HMI ECU)
+ *******************************************************************************/
+
+#ifndef APP_APP_STRINGS_H_
+#define APP_APP_STRINGS_H_
+
+#include "../Utils/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * All the text shown on the LCD, kept in flash and read with the LCD *Pgm functions.
+ * A translation is another list with the same ids selected by APP_STRING_LIST.
+ */
+#define APP_STRINGS_EN(STRING)												\
+	STRING(WELCOME,				"DOOR LOCK SECURITY SYSTEM")				\
+	STRING(AUTHOR,				"By: Marwan")								\
+	STRING(ENTER_NEW_PASSWORD,	"Please Enter A New Password:")				\
+	STRING(REENTER_PASSWORD,	"Please Re-enter The Password:")			\
+	STRING(ENTER_PASSWORD,		"Please Enter The Password:")				\
+	STRING(PASSWORD_MISMATCH,	"ERROR: Password Does Not Match.")			\
+	STRING(TRY_AGAIN,			"Please Try Again !")						\
+	STRING(LINK_LOST,			"Connection Lost, Reconnecting...")			\
+	STRING(MENU_MAIN,			"Main Menu")								\
+	STRING(MENU_OPEN_DOOR,		"Open Door")								\
+	STRING(MENU_CHANGE_PASSWORD,"New Password")								\
+	STRING(MENU_INFO,			"Info")										\
+	STRING(MENU_PROFILE,		"Profile")									\
+	STRING(MENU_UPTIME,			"Uptime")									\
+	STRING(MENU_FIRMWARE,		"Firmware")									\
+	STRING(MENU_WAKE_LATENCY,	"Wake Latency")								\
+	STRING(KEYPAD_TEST,			"Keypad Test")								\
+	STRING(KEYPAD_RAW,			"Raw")										\
+	STRING(KEYPAD_KEYS,			"Keys")										\
+	STRING(KEYPAD_GHOSTING,		"Ghosting")									\
+	STRING(FIRMWARE_VERSION,	"Door Lock v1.1")							\
+	STRING(PRESS_ANY_KEY,		"Any key: back")							\
+	STRING(DOOR_OPENING,		"The Door is Opening...")					\
+	STRING(DOOR_OPENED,			"The Door is Opened !")						\
+	STRING(DOOR_CLOSING,		"The Door is Closing...")					\
+	STRING(DOOR_OBSTACLE,		"Obstacle! The Door is Reopening...")		\
+	STRING(DOOR_HELD_OPEN,		"The Door is Left Open !")					\
+	STRING(DOOR_JAMMED,			"The Door is Jammed, Please Check It !")	\
+	STRING(PASSWORD_ACTIVE,		"The New Password Is Now Active:)")			\
+	STRING(TOO_MANY_ATTEMPTS,	"ERROR: TOO MANY ATTEMPTS !")				\
+	STRING(DOOR_LOCKED,			"DOOR IS LOCKED FOR 1 MIN..")				\
+	STRING(BENCHMARK_LINE,		"0123456789ABCDEF")
+
+/*language of the UI*/
+#define APP_STRING_LIST		APP_STRINGS_EN
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+#define APP_STRING_ID(ID, TEXT)		STR_##ID,
+
+typedef enum{
+	APP_STRING_LIST(APP_STRING_ID)
+	APP_NUM_OF_STRINGS
+}APP_StringId;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description:
+ * Return the flash address of a string, to be passed to the LCD *Pgm functions.
+ * */
+const uint8 * APP_getString(APP_StringId a_id);
+
+#endif /* APP_APP_STRINGS_H_ */
@@ -4,13 +4,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../APP/app.c 
+../APP/app.c \
+../APP/app_strings.c \
+../APP/app_menu.c 
 
 OBJS += \
-./APP/app.o 
+./APP/app.o \
+./APP/app_strings.o \
+./APP/app_menu.o 
 
 C_DEPS += \
-./APP/app.d 
+./APP/app.d \
+./APP/app_strings.d \
+./APP/app_menu.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -4,13 +4,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
-../HAL/LCD/lcd.c 
+../HAL/LCD/lcd.c \
+../HAL/LCD/lcd_format.c 
 
 OBJS += \
-./HAL/LCD/lcd.o 
+./HAL/LCD/lcd.o \
+./HAL/LCD/lcd_format.o 
 
 C_DEPS += \
-./HAL/LCD/lcd.d 
+./HAL/LCD/lcd.d \
+./HAL/LCD/lcd_format.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -23,8 +23,11 @@ SUBDIRS := \
 APP \
 HAL/Keypad \
 HAL/LCD \
+MCAL/EXTI \
 MCAL/GPIO \
+MCAL/Power \
 MCAL/Timer \
 MCAL/USART \
+MCAL/Watchdog \
 . \
 
@@ -5,8 +5,54 @@
  *******************************************************************************/
 
 #include "../../MCAL/GPIO/gpio.h"
+#include "../../MCAL/EXTI/exti.h"
+#include "../../MCAL/Power/power.h"
+#include "../../MCAL/Timer/systick.h"
+#include "../../MCAL/Watchdog/watchdog.h"
 #include "keypad.h"
-#include <util/delay.h>
+
+/*******************************************************************************
+ *                     	   	  Global Variables                                 *
+ *******************************************************************************/
+
+/*integrator of each button: counts up while pressed, down while released*/
+static uint8 g_debounceCount[KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS];
+
+/*debounced state, bit (row * KEYPAD_NUM_COLS + col) set while pressed*/
+static volatile uint16 g_keyState = 0;
+
+/*last reading of every button, each column is refreshed by its scan step*/
+static volatile uint16 g_rawState = 0;
+
+/*TRUE while the last full scan shows a rectangle of pressed buttons (see KEYPAD_isGhosting)*/
+static volatile boolean g_ghosting = FALSE;
+
+/*buttons of each chord, 0 for an unused chord*/
+static uint16 g_chords[KEYPAD_MAX_CHORDS] = {0};
+
+/*column driven by the last scan step, its rows are read by the next one*/
+static uint8 g_scanColumn = 0;
+
+/*
+ * Keypad events, written by the tick (the only writer of head)
+ * and read by the application (the only writer of tail).
+ */
+static KEYPAD_Event g_eventBuffer[KEYPAD_EVENT_BUFFER_SIZE];
+static volatile uint8 g_eventHead = 0;
+static volatile uint8 g_eventTail = 0;
+
+/*the last pressed button, the only one that reports long press and repeat*/
+static uint8 g_heldButton = KEYPAD_NO_BUTTON;
+static uint32 g_heldSince;		/*time of the press or of the last long press/repeat event*/
+static boolean g_heldLong;
+
+/*TRUE while the scanning is stopped and the wake-up line armed*/
+static volatile boolean g_keypadIdle = FALSE;
+static uint32 g_lastActivity;
+
+static uint32 g_wakeTime;
+static boolean g_wakePending = FALSE;
+static volatile uint16 g_wakeLatency = KEYPAD_NO_LATENCY;
 
 /*******************************************************************************
  *                      Functions Prototypes(Private)                          *
@@ -18,46 +64,468 @@
  */
 static uint8 getButtonChar(uint8 button_number);
 
+/*
+ * Description :
+ * Called from the tick: debounce the rows of the driven column and drive the next one.
+ */
+static void KEYPAD_scan(void);
+
+/*
+ * Description :
+ * Drive one column (or KEYPAD_ALL_COLUMNS) to the pressed level, the other columns are left floating.
+ */
+static void KEYPAD_driveColumn(uint8 a_col);
+
+/*
+ * Description :
+ * Called from the tick once the keypad is idle: stop the scanning and arm the wake-up line.
+ */
+static void KEYPAD_stopScan(void);
+
+/*
+ * Description :
+ * Called from the wake-up line interrupt: restart the scanning.
+ */
+static void KEYPAD_wakeUp(void);
+
+/*
+ * Description :
+ * Put an event in the queue from the tick, it is dropped if the queue is full.
+ */
+static void KEYPAD_pushEvent(uint8 a_key, KEYPAD_EventType a_type, uint32 a_time);
+
+/*
+ * Description :
+ * TRUE if two rows of a full matrix reading have two or more pressed columns in common.
+ */
+static boolean KEYPAD_hasRectangle(uint16 a_state);
+
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
+
+/*
+ * Description :
+ * Setup the keypad pins and start scanning it from the system tick:
+ * the rows are inputs (pulled up when a press reads low), the columns
+ * are inputs except the one being scanned.
+ */
+void KEYPAD_init(void)
+{
+	uint8 i;
+
+	for(i = 0; i < KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS; i++)
+	{
+		g_debounceCount[i] = 0;
+	}
+	g_keyState = 0;
+	g_heldButton = KEYPAD_NO_BUTTON;
+	g_eventHead = g_eventTail;
+
+	GPIO_setupPortDirection(KEYPAD_PORT_ID, PORT_INPUT);
+	for(i = 0; i < KEYPAD_NUM_ROWS; i++)
+	{
+		GPIO_writePin(KEYPAD_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID + i, KEYPAD_BUTTON_RELEASED);
+	}
+	for(i = 0; i < KEYPAD_NUM_COLS; i++)
+	{
+		/*the level of a driven column, a floating one has no pull up*/
+		GPIO_writePin(KEYPAD_PORT_ID, KEYPAD_FIRST_COLUMN_PIN_ID + i, KEYPAD_BUTTON_PRESSED);
+	}
+
+	/*pulled up, the diodes of the pressed rows pull it low*/
+	GPIO_setupPinDirection(KEYPAD_WAKE_PORT_ID, KEYPAD_WAKE_PIN_ID, PIN_INPUT);
+	GPIO_writePin(KEYPAD_WAKE_PORT_ID, KEYPAD_WAKE_PIN_ID, LOGIC_HIGH);
+	EXTI_setCallBack(KEYPAD_WAKE_EXTI_ID, KEYPAD_wakeUp);
+
+	g_keypadIdle = FALSE;
+	g_lastActivity = SYSTICK_getMs();
+	g_scanColumn = 0;
+	KEYPAD_driveColumn(g_scanColumn);
+
+	SYSTICK_subscribe(KEYPAD_scan, KEYPAD_COLUMN_PERIOD_MS);
+}
+
+/*
+ * Description :
+ * Read the oldest keypad event without waiting.
+ * Returns FALSE if the event queue is empty.
+ */
+boolean KEYPAD_getEvent(KEYPAD_Event * a_event)
+{
+	if(g_eventTail == g_eventHead)
+	{
+		return FALSE;
+	}
+
+	*a_event = g_eventBuffer[g_eventTail];
+	g_eventTail = (g_eventTail + 1) & (KEYPAD_EVENT_BUFFER_SIZE - 1);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Wait for the next keypad event.
+ */
+void KEYPAD_waitEvent(KEYPAD_Event * a_event)
+{
+	while(KEYPAD_getEvent(a_event) == FALSE)
+	{
+		WDG_checkIn(WDG_TASK_MAIN); /* waiting for the user is not a stuck loop */
+
+		if(g_keypadIdle)
+		{
+			/*nothing to do until a key is pressed, the watchdog would not be kicked in Power-down*/
+			WDG_suspend();
+			POWER_sleepWhile(POWER_DOWN, &g_keypadIdle);
+			WDG_resume();
+		}
+	}
+}
+
+/*
+ * Description :
+ * Wait up to a_timeout_ms for the next keypad event. The tick has to keep counting
+ * so the MCU never enters Power-down here, a press on an idle keypad still restarts
+ * the scanning through the wake-up interrupt.
+ * Returns FALSE if the time elapsed with no event.
+ */
+boolean KEYPAD_waitEventFor(KEYPAD_Event * a_event, uint32 a_timeout_ms)
+{
+	uint32 start = SYSTICK_getMs();
+
+	while(KEYPAD_getEvent(a_event) == FALSE)
+	{
+		WDG_checkIn(WDG_TASK_MAIN);
+
+		if((SYSTICK_getMs() - start) >= a_timeout_ms)
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Read the next pressed key without waiting, the other events are discarded.
+ * Returns FALSE if no key was pressed since the last call.
+ */
+boolean KEYPAD_getKey(uint8 * a_key)
+{
+	KEYPAD_Event event;
+
+	while(KEYPAD_getEvent(&event))
+	{
+		if(event.type == KEYPAD_EVENT_PRESSED)
+		{
+			*a_key = event.key;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Wait for the next pressed key and return it.
+ */
 uint8 KEYPAD_getPressedKey(void)
 {
-	uint8 col,row;
-	uint8 keypad_port_value = 0;
-	while(1)
+	uint8 key;
+
+	while(KEYPAD_getKey(&key) == FALSE)
+	{
+		WDG_checkIn(WDG_TASK_MAIN); /* waiting for the user is not a stuck loop */
+	}
+	return key;
+}
+
+/*
+ * Description :
+ * Discard the events not read yet.
+ */
+void KEYPAD_flush(void)
+{
+	g_eventTail = g_eventHead;
+}
+
+/*
+ * Description :
+ * Debounced state of all buttons, bit (row * KEYPAD_NUM_COLS + col) set while pressed.
+ */
+uint16 KEYPAD_getState(void)
+{
+	uint16 state;
+
+	/*a 16-bit read is not atomic on the AVR, read again if the tick changed it meanwhile*/
+	do{
+		state = g_keyState;
+	}while(state != g_keyState);
+
+	return state;
+}
+
+/*
+ * Description :
+ * Last reading of all buttons before the debounce, same bits as KEYPAD_getState.
+ */
+uint16 KEYPAD_getRawState(void)
+{
+	uint16 state;
+
+	do{
+		state = g_rawState;
+	}while(state != g_rawState);
+
+	return state;
+}
+
+/*
+ * Description :
+ * TRUE while the pressed buttons form a rectangle in the matrix, new presses are
+ * not reported until it is broken.
+ */
+boolean KEYPAD_isGhosting(void)
+{
+	return g_ghosting;
+}
+
+/*
+ * Description :
+ * Report a KEYPAD_EVENT_CHORD with the chord id as key when exactly the given
+ * buttons (KEYPAD_BUTTON_MASK) are down, 0 removes the chord.
+ * The buttons of the chord also report their own presses before it.
+ */
+void KEYPAD_setChord(uint8 a_id, uint16 a_buttons)
+{
+	if(a_id < KEYPAD_MAX_CHORDS)
 	{
-		for(col=0;col<KEYPAD_NUM_COLS;col++) /* loop for columns */
+		g_chords[a_id] = a_buttons;
+	}
+}
+
+/*
+ * Description :
+ * Time in ms from the last wake-up interrupt to the first pressed key it reported,
+ * KEYPAD_NO_LATENCY if none was measured.
+ */
+uint16 KEYPAD_getWakeLatency(void)
+{
+	uint16 latency;
+
+	do{
+		latency = g_wakeLatency;
+	}while(latency != g_wakeLatency);
+
+	return latency;
+}
+
+/*
+ * Description :
+ * Called from the tick: debounce the rows of the driven column and drive the next one.
+ * The debounced edges and the held button timing are put in the event queue.
+ */
+static void KEYPAD_scan(void)
+{
+	uint8 port = GPIO_readPort(KEYPAD_PORT_ID);
+	uint32 now = SYSTICK_getMs();
+	uint16 raw = g_rawState;
+	uint8 row;
+	uint8 button;
+	uint8 i;
+
+	/*snapshot of the column, the whole matrix is checked once its last column is read*/
+	for(row = 0; row < KEYPAD_NUM_ROWS; row++)
+	{
+		button = row * KEYPAD_NUM_COLS + g_scanColumn;
+
+		if(((port >> (KEYPAD_FIRST_ROW_PIN_ID + row)) & 0x01) == KEYPAD_BUTTON_PRESSED)
 		{
-			/*
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this column will be output pin
-			 */
-			GPIO_setupPortDirection(KEYPAD_PORT_ID,PORT_INPUT);
-			GPIO_setupPinDirection(KEYPAD_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+col,PIN_OUTPUT);
-
-#if(KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
-			/* Clear the column output pin and set the rest pins value */
-			keypad_port_value = ~(1<<(KEYPAD_FIRST_COLUMN_PIN_ID+col));
-#else
-			/* Set the column output pin and clear the rest pins value */
-			keypad_port_value = (1<<(KEYPAD_FIRST_COLUMN_PIN_ID+col));
-#endif
-			GPIO_writePort(KEYPAD_PORT_ID,keypad_port_value);
+			raw |= (1u << button);
+		}
+		else
+		{
+			raw &= ~(1u << button);
+		}
+	}
+	g_rawState = raw;
+
+	if(g_scanColumn == KEYPAD_NUM_COLS - 1)
+	{
+		g_ghosting = KEYPAD_hasRectangle(raw);
+	}
 
-			for(row=0;row<KEYPAD_NUM_ROWS;row++) /* loop for rows */
+	for(row = 0; row < KEYPAD_NUM_ROWS; row++)
+	{
+		button = row * KEYPAD_NUM_COLS + g_scanColumn;
+
+		if(BIT_IS_SET(raw, button))
+		{
+			/*a new press is held back while a ghost button may be among the pressed ones*/
+			if(g_debounceCount[button] < KEYPAD_DEBOUNCE_SCANS &&
+					!(g_ghosting && g_debounceCount[button] == KEYPAD_DEBOUNCE_SCANS - 1))
 			{
-				/* Check if the switch is pressed in this row */
-				if(GPIO_readPin(KEYPAD_PORT_ID,row+KEYPAD_FIRST_ROW_PIN_ID) == KEYPAD_BUTTON_PRESSED)
+				g_debounceCount[button]++;
+				if(g_debounceCount[button] == KEYPAD_DEBOUNCE_SCANS && BIT_IS_CLEAR(g_keyState, button))
 				{
+					g_keyState |= (1u << button);
+					KEYPAD_pushEvent(getButtonChar(button + 1), KEYPAD_EVENT_PRESSED, now);
 
-					return getButtonChar((row*KEYPAD_NUM_COLS)+col+1);
+					/*a chord is reported when its last button is pressed and no other one is down*/
+					for(i = 0; i < KEYPAD_MAX_CHORDS; i++)
+					{
+						if(g_chords[i] != 0 && g_keyState == g_chords[i])
+						{
+							KEYPAD_pushEvent(i, KEYPAD_EVENT_CHORD, now);
+						}
+					}
+
+					if(g_wakePending)
+					{
+						g_wakeLatency = (uint16)(now - g_wakeTime);
+						g_wakePending = FALSE;
+					}
+
+					g_heldButton = button;
+					g_heldSince = now;
+					g_heldLong = FALSE;
 				}
 			}
 		}
+		else if(g_debounceCount[button] != 0)
+		{
+			g_debounceCount[button]--;
+			if(g_debounceCount[button] == 0 && BIT_IS_SET(g_keyState, button))
+			{
+				g_keyState &= ~(1u << button);
+				KEYPAD_pushEvent(getButtonChar(button + 1), KEYPAD_EVENT_RELEASED, now);
+
+				if(button == g_heldButton)
+				{
+					g_heldButton = KEYPAD_NO_BUTTON;
+				}
+			}
+		}
+	}
+
+	if(g_heldButton != KEYPAD_NO_BUTTON &&
+			(now - g_heldSince) >= (g_heldLong ? KEYPAD_REPEAT_TIME : KEYPAD_LONG_PRESS_TIME))
+	{
+		KEYPAD_pushEvent(getButtonChar(g_heldButton + 1), g_heldLong ? KEYPAD_EVENT_REPEAT : KEYPAD_EVENT_LONG_PRESS, now);
+		g_heldSince = now;
+		g_heldLong = TRUE;
+	}
+
+	if(g_keyState != 0)
+	{
+		g_lastActivity = now;
+	}
+	else if((now - g_lastActivity) >= KEYPAD_IDLE_TIME)
+	{
+		KEYPAD_stopScan();
+		return;
+	}
+
+	g_scanColumn = (g_scanColumn + 1 < KEYPAD_NUM_COLS) ? g_scanColumn + 1 : 0;
+	KEYPAD_driveColumn(g_scanColumn);
+}
+
+/*
+ * Description :
+ * TRUE if two rows of a full matrix reading have two or more pressed columns in common:
+ * with three corners of such a rectangle pressed, the fourth one reads pressed
+ * through them, so any of the four may be a ghost.
+ */
+static boolean KEYPAD_hasRectangle(uint16 a_state)
+{
+	uint8 row1, row2;
+	uint8 common;
+	const uint8 columns_mask = (1u << KEYPAD_NUM_COLS) - 1;
+
+	for(row1 = 0; row1 < KEYPAD_NUM_ROWS - 1; row1++)
+	{
+		for(row2 = row1 + 1; row2 < KEYPAD_NUM_ROWS; row2++)
+		{
+			common = (a_state >> (row1 * KEYPAD_NUM_COLS)) & (a_state >> (row2 * KEYPAD_NUM_COLS)) & columns_mask;
+
+			/*clearing the lowest set bit leaves a second column if there is one*/
+			if((common & (common - 1)) != 0)
+			{
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Called from the tick once the keypad is idle: stop the scanning and drive all the
+ * columns so any press pulls the wake-up line low.
+ */
+static void KEYPAD_stopScan(void)
+{
+	SYSTICK_unsubscribe(KEYPAD_scan);
+	KEYPAD_driveColumn(KEYPAD_ALL_COLUMNS);
+	g_rawState = 0;
+	g_ghosting = FALSE;
+
+	g_keypadIdle = TRUE;
+	EXTI_enable(KEYPAD_WAKE_EXTI_ID, EXTI_LOW_LEVEL);
+}
+
+/*
+ * Description :
+ * Called from the wake-up line interrupt: the low level would trigger it again
+ * as long as the key is down, so it is disabled before the scanning restarts.
+ */
+static void KEYPAD_wakeUp(void)
+{
+	EXTI_disable(KEYPAD_WAKE_EXTI_ID);
+
+	g_wakeTime = SYSTICK_getMs();
+	g_wakePending = TRUE;
+	g_lastActivity = g_wakeTime;
+
+	g_scanColumn = 0;
+	KEYPAD_driveColumn(g_scanColumn);
+	g_keypadIdle = FALSE;
+
+	SYSTICK_subscribe(KEYPAD_scan, KEYPAD_COLUMN_PERIOD_MS);
+}
+
+/*
+ * Description :
+ * Drive one column (or KEYPAD_ALL_COLUMNS) to the pressed level, the other columns are left floating.
+ */
+static void KEYPAD_driveColumn(uint8 a_col)
+{
+	uint8 col;
+
+	for(col = 0; col < KEYPAD_NUM_COLS; col++)
+	{
+		GPIO_setupPinDirection(KEYPAD_PORT_ID, KEYPAD_FIRST_COLUMN_PIN_ID + col,
+				(col == a_col || a_col == KEYPAD_ALL_COLUMNS) ? PIN_OUTPUT : PIN_INPUT);
 	}
 }
 
+/*
+ * Description :
+ * Put an event in the queue from the tick, it is dropped if the queue is full.
+ */
+static void KEYPAD_pushEvent(uint8 a_key, KEYPAD_EventType a_type, uint32 a_time)
+{
+	uint8 next = (g_eventHead + 1) & (KEYPAD_EVENT_BUFFER_SIZE - 1);
+
+	if(next != g_eventTail)
+	{
+		g_eventBuffer[g_eventHead].key = a_key;
+		g_eventBuffer[g_eventHead].type = a_type;
+		g_eventBuffer[g_eventHead].time_ms = a_time;
+		g_eventHead = next;
+	}
+}
 
 /*
  * Description :
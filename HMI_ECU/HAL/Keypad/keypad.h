@@ -33,6 +33,46 @@
 #define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
 #define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
 
+/*
+ * The tick drives one column every KEYPAD_COLUMN_PERIOD_MS and reads its rows on the
+ * next call, so the lines settle between the two and a full scan takes
+ * KEYPAD_NUM_COLS * KEYPAD_COLUMN_PERIOD_MS.
+ * A key changes state after KEYPAD_DEBOUNCE_SCANS consecutive scans more in
+ * the new state than in the old one (integrating debounce).
+ */
+#define KEYPAD_COLUMN_PERIOD_MS          1
+#define KEYPAD_DEBOUNCE_SCANS            5       /*20 ms with 4 columns*/
+#define KEYPAD_EVENT_BUFFER_SIZE         16      /*events waiting to be read, must be a power of 2*/
+
+/*
+ * A key held KEYPAD_LONG_PRESS_TIME ms reports a long press,
+ * then a repeat every KEYPAD_REPEAT_TIME ms until it is released.
+ */
+#define KEYPAD_LONG_PRESS_TIME           800
+#define KEYPAD_REPEAT_TIME               150
+#define KEYPAD_NO_BUTTON                 0xFF
+#define KEYPAD_ALL_COLUMNS               0xFF
+
+/*combinations of buttons reported as one event, KEYPAD_BUTTON_MASK(n) is the bit of button number n*/
+#define KEYPAD_MAX_CHORDS                2
+#define KEYPAD_BUTTON_MASK(n)            (1u << ((n) - 1))
+
+/*
+ * After KEYPAD_IDLE_TIME ms without a pressed key the scanning stops: all the columns
+ * are driven and the rows, wired to the wake-up line through diodes, pull it low
+ * on any press. Its external interrupt restarts the scanning and wakes the MCU
+ * when KEYPAD_waitEvent put it in Power-down.
+ */
+#define KEYPAD_IDLE_TIME                 10000
+#define KEYPAD_WAKE_EXTI_ID              EXTI_INT1
+#define KEYPAD_WAKE_PORT_ID              PORTD_ID
+#define KEYPAD_WAKE_PIN_ID               PIN3_ID
+#define KEYPAD_NO_LATENCY                0xFFFF  /*no key was pressed after a wake-up yet*/
+
+#if (KEYPAD_BUTTON_PRESSED != LOGIC_LOW)
+#error "Only the low level of INT0/INT1 wakes the MCU from Power-down"
+#endif
+
 
 /*******************************************************************************
  *                           Keypad Configurations                             *
@@ -59,6 +99,10 @@
 		KEYPAD_BUTTON_16 = 	'+'		/* ASCII Code of '+' */
 	};
 
+	/*editing keys of the numeric entries*/
+	#define KEYPAD_KEY_BACKSPACE	KEYPAD_BUTTON_4		/* '/' erases the last digit */
+	#define KEYPAD_KEY_CLEAR		KEYPAD_BUTTON_8		/* '*' erases all the digits */
+
 #else
 
 /*Keypad with no labels (outputs button number)*/
@@ -70,6 +114,10 @@
 		KEYPAD_BUTTON_16
 	};
 
+	/*no button is left for editing, every button is a number*/
+	#define KEYPAD_KEY_BACKSPACE	KEYPAD_NO_BUTTON
+	#define KEYPAD_KEY_CLEAR		KEYPAD_NO_BUTTON
+
 #else
 
 /*the typical keypad found in market */
@@ -84,6 +132,9 @@
 			KEYPAD_BUTTON_12 = '#'
 		};
 
+		#define KEYPAD_KEY_BACKSPACE	KEYPAD_BUTTON_10	/* '*' */
+		#define KEYPAD_KEY_CLEAR		KEYPAD_NO_BUTTON
+
 	#elif (KEYPAD_NUM_COLS == 4)
 		enum{
 			KEYPAD_BUTTON_1 = 1,KEYPAD_BUTTON_2,KEYPAD_BUTTON_3,
@@ -98,6 +149,9 @@
 			KEYPAD_BUTTON_16 = 'D'
 		};
 
+		#define KEYPAD_KEY_BACKSPACE	KEYPAD_BUTTON_12	/* 'C' */
+		#define KEYPAD_KEY_CLEAR		KEYPAD_BUTTON_16	/* 'D' */
+
 	#endif /* KEYPAD_NUM_COLS */
 
 #else
@@ -107,14 +161,104 @@
 #endif /* STANDARD_KEYPAD*/
 #endif /* CUSTOM_KEYPAD */
 
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+
+typedef enum{
+	KEYPAD_EVENT_PRESSED, KEYPAD_EVENT_RELEASED, KEYPAD_EVENT_LONG_PRESS, KEYPAD_EVENT_REPEAT,
+	KEYPAD_EVENT_CHORD
+}KEYPAD_EventType;
+
+typedef struct{
+	uint8 key;					/*value of the button (KEYPAD_BUTTON_x), the chord id for KEYPAD_EVENT_CHORD*/
+	KEYPAD_EventType type;
+	uint32 time_ms;				/*system tick when the event was detected*/
+}KEYPAD_Event;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 /*
  * Description :
- * Get the Keypad pressed button
+ * Setup the keypad pins and start scanning it from the system tick.
+ */
+void KEYPAD_init(void);
+
+/*
+ * Description :
+ * Read the oldest keypad event without waiting.
+ * Returns FALSE if the event queue is empty.
+ */
+boolean KEYPAD_getEvent(KEYPAD_Event * a_event);
+
+/*
+ * Description :
+ * Wait for the next keypad event, in Power-down once the keypad is idle.
+ * The system tick stops during Power-down.
+ */
+void KEYPAD_waitEvent(KEYPAD_Event * a_event);
+
+/*
+ * Description :
+ * Wait up to a_timeout_ms for the next keypad event, without entering Power-down.
+ * Returns FALSE if the time elapsed with no event.
+ */
+boolean KEYPAD_waitEventFor(KEYPAD_Event * a_event, uint32 a_timeout_ms);
+
+/*
+ * Description :
+ * Read the next pressed key without waiting, the other events are discarded.
+ * Returns FALSE if no key was pressed since the last call.
+ */
+boolean KEYPAD_getKey(uint8 * a_key);
+
+/*
+ * Description :
+ * Wait for the next pressed key and return it.
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Description :
+ * Discard the events not read yet.
+ */
+void KEYPAD_flush(void);
+
+/*
+ * Description :
+ * Debounced state of all buttons, bit (row * KEYPAD_NUM_COLS + col) set while pressed.
+ */
+uint16 KEYPAD_getState(void);
+
+/*
+ * Description :
+ * Last reading of all buttons before the debounce, same bits as KEYPAD_getState.
+ */
+uint16 KEYPAD_getRawState(void);
+
+/*
+ * Description :
+ * TRUE while the pressed buttons form a rectangle in the matrix (a possible ghost button),
+ * new presses are not reported until it is broken.
+ */
+boolean KEYPAD_isGhosting(void);
+
+/*
+ * Description :
+ * Report a KEYPAD_EVENT_CHORD with the chord id as key when exactly the given
+ * buttons (KEYPAD_BUTTON_MASK) are down, 0 removes the chord.
+ * The buttons of the chord also report their own presses before it.
+ */
+void KEYPAD_setChord(uint8 a_id, uint16 a_buttons);
+
+/*
+ * Description :
+ * Time in ms from the last wake-up interrupt to the first pressed key it reported,
+ * KEYPAD_NO_LATENCY if none was measured. The oscillator start-up before the
+ * interrupt is not included.
+ */
+uint16 KEYPAD_getWakeLatency(void);
+
 #endif /* HAL_KEYPAD_KEYPAD_H_ */
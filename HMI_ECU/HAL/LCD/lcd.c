@@ -5,12 +5,149 @@
  *******************************************************************************/
 
 #include "../../MCAL/GPIO/gpio.h"
+#include "../../MCAL/Timer/profiler.h"
+#include "../../MCAL/Timer/systick.h"
+#include "../../MCAL/Watchdog/watchdog.h"
 #include "lcd.h"
+#include "lcd_format.h"
 #include <util/delay.h>
-#include <stdlib.h>
+#include <util/delay_basic.h>
+#include <avr/pgmspace.h>
 
-static  uint8 g_rowNum = 0;
-static  uint8 g_colNum = 0;
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The bus timing is waited with integer cycle loops: _delay_us with a constant
+ * that is not folded (-O0) pulls in the floating point math at run time.
+ * _delay_loop_1 takes 3 cycles and _delay_loop_2 4 cycles per count, the counts
+ * are rounded up (+1) so a wait is never shorter than its time.
+ */
+#define LCD_NS_TO_CYCLES(ns)		(((uint32)(ns) * (F_CPU / 1000000UL) + 999) / 1000)
+#define LCD_ENABLE_HIGH_LOOPS		((uint8)(LCD_NS_TO_CYCLES(LCD_ENABLE_HIGH_NS) / 3 + 1))
+#define LCD_ENABLE_LOW_LOOPS		((uint8)(LCD_NS_TO_CYCLES(LCD_ENABLE_LOW_NS) / 3 + 1))
+#define LCD_EXECUTION_LOOPS			((uint16)(LCD_NS_TO_CYCLES(LCD_EXECUTION_TIME_US * 1000UL) / 4 + 1))
+#define LCD_CLEAR_HOME_LOOPS		((uint16)(LCD_NS_TO_CYCLES(LCD_CLEAR_HOME_TIME_US * 1000UL) / 4 + 1))
+
+/*******************************************************************************
+ *                         Types Declaration(Private)                          *
+ *******************************************************************************/
+
+typedef enum{
+	LCD_ENTRY_COMMAND, LCD_ENTRY_DATA, LCD_ENTRY_DELAY
+}LCD_EntryType;
+
+typedef struct{
+	uint8 type;		/*LCD_EntryType*/
+	uint8 data;		/*command, character or delay in ticks*/
+}LCD_QueueEntry;
+
+typedef struct{
+	const uint8 * text;			/*string in flash*/
+	uint8 length;
+	uint8 offset;				/*position in the text shown in the first column*/
+	uint16 stepTime;			/*ticks between two steps*/
+	uint16 countdown;
+	uint8 renderCol;			/*next column to write, LCD_NUM_OF_COLS once the row is up to date*/
+	volatile boolean active;	/*set last by the application, the tick only touches active rows*/
+}LCD_Marquee;
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*
+ * Ring buffer between the application (the only writer of head) and
+ * the tick (the only writer of tail), no locking is needed.
+ */
+static LCD_QueueEntry g_lcdQueue[LCD_QUEUE_SIZE];
+static volatile uint8 g_queueHead = 0;
+static volatile uint8 g_queueTail = 0;
+
+/*ticks to skip before the next entry is written (delays and slow instructions)*/
+static volatile uint8 g_holdTicks = 0;
+
+/*TRUE while the hold waits for a slow instruction: the LCD can't take anything*/
+static boolean g_holdBusy = FALSE;
+
+/*FALSE during LCD_init: the instructions are written directly*/
+static  boolean g_queueRunning = FALSE;
+
+/*
+ * Last set address instruction with the address counter of the LCD in its
+ * low bits, followed by the only writer of the bus (the tick after LCD_init).
+ */
+static  uint8 g_busAddress = LCD_SET_CURSOR_LOCATION;
+
+/*
+ * Address the next queued entry expects on the bus: the marquee cells written
+ * by the tick between two entries move the address counter away from it.
+ */
+static  uint8 g_queueAddress = LCD_SET_CURSOR_LOCATION;
+
+static LCD_Marquee g_marquee[LCD_NUM_OF_ROWS];
+
+/*
+ * The cursor and the shadow follow the queue: they hold the state the LCD
+ * will have once all the queued entries are written.
+ */
+
+/*DDRAM address of the cursor, it follows the auto-increment of the LCD*/
+static  uint8 g_ddramAddress = 0;
+
+/*
+ * Shadow buffers of the visible DDRAM cells:
+ * g_lcdContent is what the LCD shows, g_frameBuffer is what it should show after the next flush.
+ * Direct writes update both so the buffered and direct APIs can be mixed.
+ */
+static  uint8 g_lcdContent[LCD_SHADOW_SIZE];
+static  uint8 g_frameBuffer[LCD_SHADOW_SIZE];
+
+/*DDRAM address of the first column of each row*/
+static const uint8 g_rowStartAddress[] =
+{
+		FIRST_ROW_START_ADDRESS, SECOND_ROW_START_ADDRESS, THIRD_ROW_START_ADDRESS, FOURTH_ROW_START_ADDRESS
+};
+
+/*FALSE until the data bus width is configured, the busy flag can't be read before*/
+static  boolean g_interfaceReady = FALSE;
+
+/*progress bar cells filled with 1 to 5 columns from the left*/
+static const uint8 g_progressGlyphs[LCD_PROGRESS_STEPS_PER_CELL][LCD_GLYPH_ROWS] PROGMEM =
+{
+		{0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},
+		{0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},
+		{0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},
+		{0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},
+		{0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F}
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void LCD_enqueue(uint8 a_type, uint8 a_data);
+static void LCD_delay(uint16 a_delay_ms);
+static void LCD_service(void);
+static void LCD_transfer(uint8 a_type, uint8 a_data);
+static void LCD_writeRaw(uint8 a_type, uint8 a_data);
+static void LCD_marqueeTick(void);
+static void LCD_marqueeRender(uint8 a_row);
+static void LCD_marqueeWrite(void);
+static boolean LCD_isMarqueeCell(uint8 a_index);
+static boolean LCD_isLongInstruction(uint8 a_command);
+static void LCD_bufferWriteFrom(uint8 a_address, const uint8 * a_str, boolean a_inFlash);
+static void LCD_setAddress(uint8 a_address);
+static uint8 LCD_nextAddress(uint8 a_address);
+static uint8 LCD_shadowIndex(uint8 a_address);
+static void LCD_shadowFill(uint8 * a_shadow, uint8 a_data);
+static void LCD_pulseEnable(void);
+static void LCD_writeByte(uint8 a_data);
+static void LCD_waitReady(boolean a_longInstruction);
+#if (LCD_RW_CONNECTED == 1)
+static uint8 LCD_readBusyFlag(void);
+#endif
 
 /*
  * Description :
@@ -23,6 +160,15 @@ void LCD_init(void){
 	GPIO_setupPinDirection(LCD_RS_PORT_ID, LCD_RS_PIN_ID, PIN_OUTPUT);
 	GPIO_setupPinDirection(LCD_E_PORT_ID, LCD_E_PIN_ID, PIN_OUTPUT);
 
+#if (LCD_RW_CONNECTED == 1)
+	/*RW is low (write) except while the busy flag is read*/
+	GPIO_setupPinDirection(LCD_RW_PORT_ID, LCD_RW_PIN_ID, PIN_OUTPUT);
+	GPIO_writePin(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_LOW);
+#endif
+
+	/*the busy flag is not valid until the interface is configured*/
+	g_interfaceReady = FALSE;
+
 	_delay_ms(20); /* LCD Power ON delay > 15ms */
 
 #if (LCD_DATA_BITS_MODE == 8)
@@ -44,8 +190,17 @@ void LCD_init(void){
 	LCD_sendCommand(LCD_FOUR_BITS_MODE);
 #endif
 
+	g_interfaceReady = TRUE;
+
 	LCD_sendCommand(LCD_CURSOR_OFF);
-	LCD_sendCommand(LCD_CLEAR_DISPLAY); /* clear LCD at the beginning */
+	LCD_clearScreen(); /* clear LCD at the beginning */
+
+	/*from now on the instructions are queued and written by the tick*/
+	g_queueAddress = g_busAddress;
+	if(g_queueRunning == FALSE){
+		SYSTICK_subscribe(LCD_service, 1);
+		g_queueRunning = TRUE;
+	}
 }
 
 /*
@@ -53,65 +208,478 @@ void LCD_init(void){
  * Send the required command to the screen
  */
 void LCD_sendCommand(uint8 command){
-	GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_LOW);
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);
-	_delay_ms(1);
+	PROF_BEGIN(PROF_ID_LCD_SEND_COMMAND);
+
+	if(g_queueRunning){
+		LCD_enqueue(LCD_ENTRY_COMMAND, command);
+	}
+	else{
+		LCD_transfer(LCD_ENTRY_COMMAND, command);
+		LCD_waitReady(LCD_isLongInstruction(command));
+	}
+
+	PROF_END(PROF_ID_LCD_SEND_COMMAND);
+}
+
+/*
+ * Description :
+ * Display the required character on the screen
+ */
+void LCD_displayCharacter(uint8 data){
+	uint8 index;
+
+	PROF_BEGIN(PROF_ID_LCD_DISPLAY_CHARACTER);
+
+	if(g_queueRunning){
+		LCD_enqueue(LCD_ENTRY_DATA, data);
+	}
+	else{
+		LCD_transfer(LCD_ENTRY_DATA, data);
+		LCD_waitReady(FALSE);
+	}
+
+	/*keep the shadow in step with the DDRAM cell and increment cursor position*/
+	index = LCD_shadowIndex(g_ddramAddress);
+	if(index < LCD_SHADOW_SIZE){
+		g_lcdContent[index] = data;
+		g_frameBuffer[index] = data;
+	}
+	g_ddramAddress = LCD_nextAddress(g_ddramAddress);
+
+	PROF_END(PROF_ID_LCD_DISPLAY_CHARACTER);
+}
+
+/*
+ * Description :
+ * Add an entry to the queue, wait for a free slot if the queue is full.
+ * Must not be called with the interrupts disabled.
+ */
+static void LCD_enqueue(uint8 a_type, uint8 a_data){
+	uint8 next = (g_queueHead + 1) & (LCD_QUEUE_SIZE - 1);
+
+	while(next == g_queueTail){
+		WDG_checkIn(WDG_TASK_MAIN); /*the tick is writing the queue*/
+	}
+
+	g_lcdQueue[g_queueHead].type = a_type;
+	g_lcdQueue[g_queueHead].data = a_data;
+	g_queueHead = next;		/*publish the entry once it is complete*/
+}
+
+/*
+ * Description :
+ * Hold the following entries for a delay (1 tick = 1 ms),
+ * delays longer than 255 ms take more than one entry.
+ */
+static void LCD_delay(uint16 a_delay_ms){
+	uint8 chunk;
+
+	if(g_queueRunning == FALSE){
+		for(; a_delay_ms > 0; a_delay_ms--){
+			_delay_ms(1);
+		}
+		return;
+	}
+
+	while(a_delay_ms > 0){
+		chunk = (a_delay_ms > 0xFF) ? 0xFF : (uint8)a_delay_ms;
+		LCD_enqueue(LCD_ENTRY_DELAY, chunk);
+		a_delay_ms -= chunk;
+	}
+}
+
+/*
+ * Description :
+ * Called every tick: write one queued entry. The next tick comes after its
+ * execution time (37 us), nothing is waited for and the busy flag is never read
+ * here. A delay entry or a slow instruction holds the queue for the next ticks.
+ * If a marquee moved the address counter, the tick puts it back first.
+ */
+static void LCD_service(void){
+	LCD_QueueEntry entry;
+
+	LCD_marqueeTick();
+
+	if(g_holdTicks != 0){
+		g_holdTicks--;
+		/*the LCD is free during a delay entry, the marquees keep moving*/
+		if(g_holdBusy == FALSE){
+			LCD_marqueeWrite();
+		}
+		return;
+	}
+
+	PROF_BEGIN(PROF_ID_LCD_SERVICE);
+
+	g_holdBusy = FALSE;
+
+	if(g_queueTail != g_queueHead){
+		entry = g_lcdQueue[g_queueTail];
+
+		if(g_busAddress != g_queueAddress && entry.type != LCD_ENTRY_DELAY &&
+		   !(entry.type == LCD_ENTRY_COMMAND && ((entry.data & (LCD_SET_CURSOR_LOCATION | LCD_SET_CGRAM_ADDRESS)) || LCD_isLongInstruction(entry.data)))){
+			/*the entry is written next tick, after the address it expects*/
+			LCD_transfer(LCD_ENTRY_COMMAND, g_queueAddress);
+		}
+		else if(entry.type == LCD_ENTRY_DELAY){
+			g_queueTail = (g_queueTail + 1) & (LCD_QUEUE_SIZE - 1);
+			g_holdTicks = entry.data;
+		}
+		else{
+			g_queueTail = (g_queueTail + 1) & (LCD_QUEUE_SIZE - 1);
+			LCD_transfer(entry.type, entry.data);
+			g_queueAddress = g_busAddress;
+
+			if(entry.type == LCD_ENTRY_COMMAND && LCD_isLongInstruction(entry.data)){
+				g_holdTicks = LCD_CLEAR_HOME_TICKS;
+				g_holdBusy = TRUE;
+			}
+		}
+	}
+	else{
+		/*the marquees only get the ticks left by the queued entries*/
+		LCD_marqueeWrite();
+	}
+
+	PROF_END(PROF_ID_LCD_SERVICE);
+}
+
+/*
+ * Description :
+ * Write a command or a character to the LCD without waiting for its execution.
+ */
+static void LCD_transfer(uint8 a_type, uint8 a_data){
+	PROF_BEGIN(PROF_ID_LCD_TRANSFER);
+
+	if(a_type == LCD_ENTRY_DATA){
+		SET_BIT(LCD_RS_PORT_REG, LCD_RS_PIN_ID);
+	}
+	else{
+		CLEAR_BIT(LCD_RS_PORT_REG, LCD_RS_PIN_ID);
+	}
+	LCD_writeByte(a_data);
+
+	PROF_END(PROF_ID_LCD_TRANSFER);
+
+	/*follow the address counter of the LCD*/
+	if(a_type == LCD_ENTRY_DATA){
+		if(g_busAddress & LCD_SET_CURSOR_LOCATION){
+			g_busAddress = LCD_SET_CURSOR_LOCATION | LCD_nextAddress(g_busAddress & 0x7F);
+		}
+		else{
+			g_busAddress = LCD_SET_CGRAM_ADDRESS | ((g_busAddress + 1) & 0x3F);
+		}
+	}
+	else if(a_data & (LCD_SET_CURSOR_LOCATION | LCD_SET_CGRAM_ADDRESS)){
+		g_busAddress = a_data;
+	}
+	else if(LCD_isLongInstruction(a_data)){
+		g_busAddress = LCD_SET_CURSOR_LOCATION | FIRST_ROW_START_ADDRESS;
+	}
+}
+
+/*
+ * Description :
+ * Write a command or a byte that is not a DDRAM character (CGRAM data):
+ * the cursor and the shadow buffers are left untouched.
+ */
+static void LCD_writeRaw(uint8 a_type, uint8 a_data){
+	if(g_queueRunning){
+		LCD_enqueue(a_type, a_data);
+	}
+	else{
+		LCD_transfer(a_type, a_data);
+		LCD_waitReady(FALSE);
+	}
+}
+
+/*
+ * Description :
+ * Called every tick: advance the marquees whose step time has elapsed,
+ * their rows are rendered again in the shadow buffer.
+ */
+static void LCD_marqueeTick(void){
+	uint8 row;
+	LCD_Marquee * marquee;
+
+	for(row = 0; row < LCD_NUM_OF_ROWS; row++){
+		marquee = &g_marquee[row];
+		if(marquee->active && marquee->length > LCD_NUM_OF_COLS && --marquee->countdown == 0){
+			marquee->countdown = marquee->stepTime;
+			marquee->offset++;
+			if(marquee->offset == marquee->length + LCD_MARQUEE_GAP){
+				marquee->offset = 0;
+			}
+			LCD_marqueeRender(row);
+		}
+	}
+}
+
+/*
+ * Description :
+ * Render the current step of a marquee in its row of the shadow buffer,
+ * the row is then written from its first column.
+ */
+static void LCD_marqueeRender(uint8 a_row){
+	uint8 col;
+	uint16 position;
+	uint8 first = LCD_shadowIndex(g_rowStartAddress[a_row]);
+	LCD_Marquee * marquee = &g_marquee[a_row];
+
+	for(col = 0; col < LCD_NUM_OF_COLS; col++){
+		position = marquee->offset + col;
+		/*a string that fits in the row doesn't come around again*/
+		if(marquee->length > LCD_NUM_OF_COLS && position >= marquee->length + LCD_MARQUEE_GAP){
+			position -= marquee->length + LCD_MARQUEE_GAP;
+		}
+		g_frameBuffer[first + col] = (position < marquee->length) ? pgm_read_byte(marquee->text + position) : ' ';
+	}
+	marquee->renderCol = 0;
+}
+
+/*
+ * Description :
+ * Write one entry for the first marquee cell that differs from the LCD contents:
+ * its address if the address counter is elsewhere, otherwise its character
+ * (cells that already show the right character cost nothing).
+ */
+static void LCD_marqueeWrite(void){
+	uint8 row;
+	uint8 address;
+	uint8 index;
+	LCD_Marquee * marquee;
+
+	for(row = 0; row < LCD_NUM_OF_ROWS; row++){
+		marquee = &g_marquee[row];
+		if(marquee->active == FALSE){
+			continue;
+		}
+
+		while(marquee->renderCol < LCD_NUM_OF_COLS){
+			address = g_rowStartAddress[row] + marquee->renderCol;
+			index = LCD_shadowIndex(address);
+			if(g_lcdContent[index] != g_frameBuffer[index]){
+				if(g_busAddress != (LCD_SET_CURSOR_LOCATION | address)){
+					LCD_transfer(LCD_ENTRY_COMMAND, LCD_SET_CURSOR_LOCATION | address);
+				}
+				else{
+					LCD_transfer(LCD_ENTRY_DATA, g_frameBuffer[index]);
+					g_lcdContent[index] = g_frameBuffer[index];
+					marquee->renderCol++;
+				}
+				return;
+			}
+			marquee->renderCol++;
+		}
+	}
+}
+
+/*
+ * Description :
+ * TRUE if a shadow cell belongs to the row of a running marquee.
+ */
+static boolean LCD_isMarqueeCell(uint8 a_index){
+	uint8 row;
+	uint8 first;
+
+	for(row = 0; row < LCD_NUM_OF_ROWS; row++){
+		if(g_marquee[row].active){
+			first = LCD_shadowIndex(g_rowStartAddress[row]);
+			if(a_index >= first && a_index < first + LCD_NUM_OF_COLS){
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description :
+ * Clear display and return home are the only slow instructions.
+ */
+static boolean LCD_isLongInstruction(uint8 a_command){
+	return (a_command == LCD_CLEAR_DISPLAY) || (a_command == LCD_CURSOR_GO_HOME);
+}
+
+/*
+ * Description :
+ * Copy a string from SRAM or flash in the shadow buffer from a DDRAM address.
+ */
+static void LCD_bufferWriteFrom(uint8 a_address, const uint8 * a_str, boolean a_inFlash){
+	uint8 character;
+	uint8 index;
+
+	while(1){
+		character = a_inFlash ? pgm_read_byte(a_str) : *a_str;
+		if(character == '\0'){
+			break;
+		}
+		a_str++;
+
+		index = LCD_shadowIndex(a_address);
+		if(index < LCD_SHADOW_SIZE){
+			g_frameBuffer[index] = character;
+		}
+		a_address = LCD_nextAddress(a_address);
+	}
+}
+
+/*
+ * Description :
+ * Move the cursor to a DDRAM address.
+ */
+static void LCD_setAddress(uint8 a_address){
+	LCD_sendCommand(LCD_SET_CURSOR_LOCATION | a_address);
+	g_ddramAddress = a_address;
+}
+
+/*
+ * Description :
+ * Address of the next DDRAM cell: each line holds 40 characters and the
+ * end of a line continues at the start of the other one.
+ */
+static uint8 LCD_nextAddress(uint8 a_address){
+	a_address++;
+	if(a_address == FIRST_ROW_START_ADDRESS + 40){
+		a_address = LCD_SECOND_LINE_ADDRESS;
+	}
+	else if(a_address == LCD_SECOND_LINE_ADDRESS + 40){
+		a_address = FIRST_ROW_START_ADDRESS;
+	}
+	return a_address;
+}
+
+/*
+ * Description :
+ * Index of a DDRAM address in the shadow buffers, LCD_SHADOW_SIZE if the
+ * cell is not visible on the panel.
+ */
+static uint8 LCD_shadowIndex(uint8 a_address){
+	if(a_address < LCD_SHADOW_LINE_LENGTH){
+		return a_address;
+	}
+	else if(a_address >= LCD_SECOND_LINE_ADDRESS && a_address < LCD_SECOND_LINE_ADDRESS + LCD_SHADOW_LINE_LENGTH){
+		return a_address - LCD_SECOND_LINE_ADDRESS + LCD_SHADOW_LINE_LENGTH;
+	}
+	return LCD_SHADOW_SIZE;
+}
 
-#if (LCD_DATA_BITS_MODE ==8)
-	GPIO_writePort(LCD_DATA_PORT_ID, command);
+static void LCD_shadowFill(uint8 * a_shadow, uint8 a_data){
+	uint8 i;
+	for(i = 0; i < LCD_SHADOW_SIZE; i++){
+		a_shadow[i] = a_data;
+	}
+}
+
+/*
+ * Description :
+ * Latch the data bus into the LCD with a short pulse on the enable pin.
+ */
+static void LCD_pulseEnable(void){
+	SET_BIT(LCD_E_PORT_REG, LCD_E_PIN_ID);
+	_delay_loop_1(LCD_ENABLE_HIGH_LOOPS);
+	CLEAR_BIT(LCD_E_PORT_REG, LCD_E_PIN_ID);
+	_delay_loop_1(LCD_ENABLE_LOW_LOOPS);
+}
 
-#elif (LCD_DATA_BITS_MODE ==4)
+/*
+ * Description :
+ * Write a byte on the data bus, RS must be already set by the caller.
+ */
+static void LCD_writeByte(uint8 a_data){
+#if (LCD_DATA_BITS_MODE == 8)
+	LCD_DATA_PORT_REG = a_data;
+	LCD_pulseEnable();
 
-	GPIO_writeNibble(LCD_DATA_PORT_ID, GET_NIBBLE(command,MSN), LCD_DATA_PIN_1_ID);
-	_delay_ms(1);
+#elif (LCD_DATA_BITS_MODE == 4)
+	/*the other pins of the data port keep their value*/
+	uint8 port = LCD_DATA_PORT_REG & ~(0x0F << LCD_DATA_PIN_1_ID);
 
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);
-	_delay_ms(1);
+	LCD_DATA_PORT_REG = port | (GET_NIBBLE(a_data,MSN) << LCD_DATA_PIN_1_ID);
+	LCD_pulseEnable();
 
-	GPIO_writeNibble(LCD_DATA_PORT_ID, GET_NIBBLE(command,LSN), LCD_DATA_PIN_1_ID);
+	if(g_interfaceReady == FALSE){
+		/*each nibble is a full 8-bit function set until 4-bit mode is configured*/
+		_delay_ms(LCD_INIT_COMMAND_DELAY_MS);
+	}
 
+	LCD_DATA_PORT_REG = port | (GET_NIBBLE(a_data,LSN) << LCD_DATA_PIN_1_ID);
+	LCD_pulseEnable();
 #endif
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);
-	_delay_ms(1);
 }
 
 /*
  * Description :
- * Display the required character on the screen
+ * Wait until the LCD has executed the last instruction:
+ * poll the busy flag when RW is connected, otherwise wait the worst case
+ * execution time of the instruction (long for clear display and return home).
  */
-void LCD_displayCharacter(uint8 data){
-	GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_HIGH);
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);
-	_delay_ms(1);
+static void LCD_waitReady(boolean a_longInstruction){
+	if(g_interfaceReady == FALSE){
+		/*the first function set commands can't be followed by a busy flag read*/
+		_delay_ms(LCD_INIT_COMMAND_DELAY_MS);
+		return;
+	}
+
+#if (LCD_RW_CONNECTED == 1)
+	(void)a_longInstruction;
+	while(LCD_readBusyFlag()){
+		; /*wait*/
+	}
+#else
+	if(a_longInstruction){
+		_delay_loop_2(LCD_CLEAR_HOME_LOOPS);
+	}
+	else{
+		_delay_loop_2(LCD_EXECUTION_LOOPS);
+	}
+#endif
+}
+
+#if (LCD_RW_CONNECTED == 1)
+/*
+ * Description :
+ * Read the busy flag (DB7 of the instruction register).
+ * The data bus is turned into an input for the read and back to output after it.
+ */
+static uint8 LCD_readBusyFlag(void){
+	uint8 busy;
+
+	GPIO_writePin(LCD_RS_PORT_ID, LCD_RS_PIN_ID, LOGIC_LOW);
+	GPIO_writePin(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_HIGH);
 
 #if (LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID, data);
+	GPIO_setupPortDirection(LCD_DATA_PORT_ID, PORT_INPUT);
+
+	SET_BIT(LCD_E_PORT_REG, LCD_E_PIN_ID);
+	_delay_loop_1(LCD_ENABLE_HIGH_LOOPS);	/*data delay time: 160 ns*/
+	busy = GPIO_readPin(LCD_DATA_PORT_ID, PIN7_ID);
+	CLEAR_BIT(LCD_E_PORT_REG, LCD_E_PIN_ID);
+	_delay_loop_1(LCD_ENABLE_LOW_LOOPS);
+
+	GPIO_setupPortDirection(LCD_DATA_PORT_ID, PORT_OUTPUT);
 
 #elif (LCD_DATA_BITS_MODE == 4)
-	GPIO_writeNibble(LCD_DATA_PORT_ID,  GET_NIBBLE(data,MSN), LCD_DATA_PIN_1_ID);
-	_delay_ms(1);
+	GPIO_setupNibbleDirection(LCD_DATA_PORT_ID, NIBBLE_INPUT, LCD_DATA_PIN_1_ID);
 
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_HIGH);
-	_delay_ms(1);
+	/*the busy flag comes with the high nibble*/
+	SET_BIT(LCD_E_PORT_REG, LCD_E_PIN_ID);
+	_delay_loop_1(LCD_ENABLE_HIGH_LOOPS);
+	busy = GPIO_readPin(LCD_DATA_PORT_ID, LCD_DATA_PIN_1_ID + 3);
+	CLEAR_BIT(LCD_E_PORT_REG, LCD_E_PIN_ID);
+	_delay_loop_1(LCD_ENABLE_LOW_LOOPS);
 
-	GPIO_writeNibble(LCD_DATA_PORT_ID,  GET_NIBBLE(data,LSN), LCD_DATA_PIN_1_ID);
+	/*the low nibble (address counter) must be clocked out as well*/
+	LCD_pulseEnable();
 
+	GPIO_setupNibbleDirection(LCD_DATA_PORT_ID, NIBBLE_OUTPUT, LCD_DATA_PIN_1_ID);
 #endif
 
-	_delay_ms(1);
-	GPIO_writePin(LCD_E_PORT_ID, LCD_E_PIN_ID, LOGIC_LOW);
-	_delay_ms(1);
+	GPIO_writePin(LCD_RW_PORT_ID, LCD_RW_PIN_ID, LOGIC_LOW);
 
-	/*increment cursor position*/
-	g_colNum++;
+	return busy;
 }
+#endif
 
 /*
  * Description :
@@ -119,9 +687,22 @@ void LCD_displayCharacter(uint8 data){
  */
 void LCD_displayString(const uint8 * strConst){
 	uint8 i=0;
+	PROF_BEGIN(PROF_ID_LCD_DISPLAY_STRING);
 	for(i=0;strConst[i] != '\0';i++){
 		LCD_displayCharacter(strConst[i]);
 	}
+	PROF_END(PROF_ID_LCD_DISPLAY_STRING);
+}
+
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) on the screen
+ */
+void LCD_displayStringPgm(const uint8 * strFlash){
+	uint8 character;
+	while((character = pgm_read_byte(strFlash++)) != '\0'){
+		LCD_displayCharacter(character);
+	}
 }
 
 /*
@@ -129,10 +710,12 @@ void LCD_displayString(const uint8 * strConst){
  * display a given data briefly, then replace it with a given symbol
  */
 void LCD_characterFade(uint8 a_data, uint8 a_symbol){
+	uint8 address = g_ddramAddress;
+
+	/*the symbol is written back at the same cell once the delay entry has elapsed*/
 	LCD_displayCharacter(a_data);
-	g_colNum--;
-	_delay_ms(CHARACTER_FADE_DELAY);
-	LCD_moveCursor(g_rowNum, g_colNum);
+	LCD_delay(CHARACTER_FADE_DELAY);
+	LCD_setAddress(address);
 	LCD_displayCharacter(a_symbol);
 }
 /*
@@ -143,7 +726,19 @@ void LCD_writeString(const uint8 * strConst, const uint16 a_writeDelay_ms){
 	uint8 i=0;
 	for(i=0;strConst[i] != '\0';i++){
 		LCD_displayCharacter(strConst[i]);
-		_delay_ms(a_writeDelay_ms);
+		LCD_delay(a_writeDelay_ms);
+	}
+}
+
+/*
+ * Description :
+ * write the required string stored in flash (PROGMEM) on the screen with delay effect
+ */
+void LCD_writeStringPgm(const uint8 * strFlash, const uint16 a_writeDelay_ms){
+	uint8 character;
+	while((character = pgm_read_byte(strFlash++)) != '\0'){
+		LCD_displayCharacter(character);
+		LCD_delay(a_writeDelay_ms);
 	}
 }
 
@@ -170,12 +765,7 @@ void LCD_moveCursor(uint8 row, uint8 col){
 		break;
 	}
 	/* Move the LCD cursor to this specific address */
-	LCD_sendCommand(LCD_SET_CURSOR_LOCATION | lcd_location_address);
-
-	/*change cursor position*/
-	g_rowNum = row;
-	g_colNum = col;
-
+	LCD_setAddress(lcd_location_address);
 }
 
 /*
@@ -187,14 +777,21 @@ void LCD_displayStringRowColumn(uint8 row, uint8 col, const uint8 * str){
 	LCD_displayString(str);
 }
 
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumnPgm(uint8 row, uint8 col, const uint8 * strFlash){
+	LCD_moveCursor(row, col); /* go to to the required LCD position */
+	LCD_displayStringPgm(strFlash);
+}
+
 /*
  * Description :
  * Display the required decimal value on the screen
  */
 void LCD_intgerToString(int data){
-	uint8 buffer[16];					/* String to hold the ascii result */
-	itoa(data, buffer, DECIMAL_RADIX); 	/* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-	LCD_displayString(buffer);
+	LCD_displayDecimal((sint16)data);	/*digit pairs written straight to the LCD, no string on the stack*/
 }
 
 /*
@@ -202,7 +799,207 @@ void LCD_intgerToString(int data){
  * Send the clear screen command
  */
 void LCD_clearScreen(void){
+	uint8 row;
+
+	for(row = 0; row < LCD_NUM_OF_ROWS; row++){
+		g_marquee[row].active = FALSE;
+	}
+
 	LCD_sendCommand(LCD_CLEAR_DISPLAY); /*send clear display command*/
+
+	/*the LCD fills the DDRAM with spaces and returns the cursor home*/
+	LCD_shadowFill(g_lcdContent, ' ');
+	LCD_shadowFill(g_frameBuffer, ' ');
+	g_ddramAddress = FIRST_ROW_START_ADDRESS;
+}
+
+/*
+ * Description :
+ * Return TRUE when every queued command, data byte and delay has been executed.
+ */
+boolean LCD_isIdle(void){
+	return (g_queueHead == g_queueTail) && (g_holdTicks == 0);
+}
+
+/*
+ * Description :
+ * Fill the shadow buffer with spaces and stop the marquees, the screen is not touched until LCD_flush.
+ */
+void LCD_bufferClear(void){
+	uint8 row;
+
+	/*the tick stops rendering the marquee rows first*/
+	for(row = 0; row < LCD_NUM_OF_ROWS; row++){
+		LCD_marqueeStop(row);
+	}
+	LCD_shadowFill(g_frameBuffer, ' ');
+}
+
+/*
+ * Description :
+ * Write a character in the shadow buffer only.
+ */
+void LCD_bufferWriteCharacter(uint8 row, uint8 col, uint8 data){
+	uint8 index = LCD_shadowIndex(g_rowStartAddress[row & 0x03] + col);
+
+	if(index < LCD_SHADOW_SIZE){
+		g_frameBuffer[index] = data;
+	}
+}
+
+/*
+ * Description :
+ * Write a string in the shadow buffer only, starting at a row and column index.
+ * The string continues in DDRAM order like the LCD auto-increment does.
+ */
+void LCD_bufferWriteString(uint8 row, uint8 col, const uint8 * str){
+	LCD_bufferWriteFrom(g_rowStartAddress[row & 0x03] + col, str, FALSE);
+}
+
+/*
+ * Description :
+ * Write a string stored in flash (PROGMEM) in the shadow buffer only.
+ */
+void LCD_bufferWriteStringPgm(uint8 row, uint8 col, const uint8 * strFlash){
+	LCD_bufferWriteFrom(g_rowStartAddress[row & 0x03] + col, strFlash, TRUE);
+}
+
+/*
+ * Description :
+ * Write a string stored in flash (PROGMEM) in a field of width cells of the shadow buffer:
+ * a longer string is cut, a shorter one is padded with spaces.
+ */
+void LCD_bufferWriteFieldPgm(uint8 row, uint8 col, const uint8 * strFlash, uint8 width){
+	uint8 i;
+	uint8 character = ' ';
+	boolean ended = FALSE;
+
+	for(i = 0; i < width; i++){
+		if(ended == FALSE){
+			character = pgm_read_byte(strFlash + i);
+			if(character == '\0'){
+				ended = TRUE;
+				character = ' ';
+			}
+		}
+		LCD_bufferWriteCharacter(row, col + i, character);
+	}
+}
+
+/*
+ * Description :
+ * Bring the screen up to date with the shadow buffer: only the cells that differ
+ * from the LCD contents are written, one cursor move per run of changed cells
+ * (the cursor is already in place for the next cell of a run).
+ */
+void LCD_flush(void){
+	uint8 index;
+	uint8 address;
+
+	for(index = 0; index < LCD_SHADOW_SIZE; index++){
+		if(g_frameBuffer[index] != g_lcdContent[index] && !LCD_isMarqueeCell(index)){
+			address = (index < LCD_SHADOW_LINE_LENGTH) ? index : (LCD_SECOND_LINE_ADDRESS + index - LCD_SHADOW_LINE_LENGTH);
+			if(address != g_ddramAddress){
+				LCD_setAddress(address);
+			}
+			LCD_displayCharacter(g_frameBuffer[index]);
+		}
+	}
+}
+
+/*
+ * Description :
+ * Scroll a string stored in flash (PROGMEM) through a row, one column every step time.
+ * The row belongs to the marquee until it is stopped: LCD_flush leaves it alone.
+ * A string that fits in the row is displayed without scrolling.
+ */
+void LCD_marqueeStartPgm(uint8 row, const uint8 * strFlash, uint16 a_stepTime_ms){
+	LCD_Marquee * marquee = &g_marquee[row & 0x03];
+	uint8 length = 0;
+
+	/*the tick leaves the row alone while it is set up*/
+	marquee->active = FALSE;
+
+	while(length < 0xFF && pgm_read_byte(strFlash + length) != '\0'){
+		length++;
+	}
+
+	marquee->text = strFlash;
+	marquee->length = length;
+	marquee->offset = 0;
+	marquee->stepTime = (a_stepTime_ms != 0) ? a_stepTime_ms : 1;
+	marquee->countdown = marquee->stepTime;
+	LCD_marqueeRender(row & 0x03);
+	marquee->active = TRUE;
+}
+
+/*
+ * Description :
+ * Stop the marquee of a row, its last step stays in the shadow buffer and
+ * LCD_flush writes the row again.
+ */
+void LCD_marqueeStop(uint8 row){
+	g_marquee[row & 0x03].active = FALSE;
+}
+
+/*
+ * Description :
+ * Load a custom character (8 rows of 5 bits, first row first) stored in flash (PROGMEM)
+ * into CGRAM, it is displayed by writing its index (0 to 7) as a character.
+ */
+void LCD_loadGlyphPgm(uint8 a_index, const uint8 * patternFlash){
+	uint8 i;
+
+	LCD_writeRaw(LCD_ENTRY_COMMAND, LCD_SET_CGRAM_ADDRESS | ((a_index & (LCD_NUM_OF_GLYPHS - 1)) * LCD_GLYPH_ROWS));
+	for(i = 0; i < LCD_GLYPH_ROWS; i++){
+		LCD_writeRaw(LCD_ENTRY_DATA, pgm_read_byte(patternFlash + i));
+	}
+
+	/*the next characters go to DDRAM again, at the cursor*/
+	LCD_writeRaw(LCD_ENTRY_COMMAND, LCD_SET_CURSOR_LOCATION | g_ddramAddress);
+}
+
+/*
+ * Description :
+ * Load the partial-fill characters used by the progress bar.
+ */
+void LCD_progressBarInit(void){
+	uint8 i;
+
+	for(i = 0; i < LCD_PROGRESS_STEPS_PER_CELL; i++){
+		LCD_loadGlyphPgm(LCD_PROGRESS_FIRST_GLYPH + i, g_progressGlyphs[i]);
+	}
+}
+
+/*
+ * Description :
+ * Draw a progress bar in the shadow buffer only, width cells starting at a row and column index.
+ * Each cell has 5 steps, so LCD_flush only writes the cell whose fill changed.
+ */
+void LCD_bufferProgressBar(uint8 row, uint8 col, uint8 width, uint8 a_percent){
+	uint16 filled;
+	uint8 cell;
+
+	if(a_percent > 100){
+		a_percent = 100;
+	}
+
+	/*number of filled columns, rounded to the nearest one*/
+	filled = ((uint16)a_percent * width * LCD_PROGRESS_STEPS_PER_CELL + 50) / 100;
+
+	for(cell = 0; cell < width; cell++){
+		if(filled >= LCD_PROGRESS_STEPS_PER_CELL){
+			LCD_bufferWriteCharacter(row, col + cell, LCD_PROGRESS_FIRST_GLYPH + LCD_PROGRESS_STEPS_PER_CELL - 1);
+			filled -= LCD_PROGRESS_STEPS_PER_CELL;
+		}
+		else if(filled != 0){
+			LCD_bufferWriteCharacter(row, col + cell, LCD_PROGRESS_FIRST_GLYPH + filled - 1);
+			filled = 0;
+		}
+		else{
+			LCD_bufferWriteCharacter(row, col + cell, ' ');
+		}
+	}
 }
 
 /*
@@ -212,12 +1009,13 @@ void LCD_clearScreen(void){
  */
 void LCD_shiftDisplay(LCD_ShiftDirection direction, uint16 delay_time_ms){
 	static volatile uint8 var =0;
-	_delay_ms(delay_time_ms);
+	LCD_delay(delay_time_ms);
 
 	/*check if the maximum left shift is reached*/
 	if(var == MAX_SHIFT_LEFT_AMOUNT){
 		var =0;
 		LCD_sendCommand(LCD_CURSOR_GO_HOME); /*send cursor back to row 0 col 0*/
+		g_ddramAddress = FIRST_ROW_START_ADDRESS;
 		return;
 	}
 	if(direction == RIGHT){
@@ -23,6 +23,18 @@
 #define THIRD_ROW_START_ADDRESS 	0X10
 #define FOURTH_ROW_START_ADDRESS 	0X50
 
+/*
+ * RAM shadow of the DDRAM: the visible part of the two DDRAM lines.
+ * Rows 2 and 3 of the panel are the continuation of rows 0 and 1 in DDRAM,
+ * a string running past the end of row 0 continues on row 2.
+ */
+#define LCD_NUM_OF_ROWS			4
+#define LCD_NUM_OF_COLS			16
+#define LCD_DDRAM_LINES			2
+#define LCD_SHADOW_LINE_LENGTH	32
+#define LCD_SHADOW_SIZE			(LCD_DDRAM_LINES * LCD_SHADOW_LINE_LENGTH)
+#define LCD_SECOND_LINE_ADDRESS	SECOND_ROW_START_ADDRESS
+
 #define BINARY_RADIX			2
 #define DECIMAL_RADIX			10
 #define HEXADECIMAL_RADIX		16
@@ -43,6 +55,18 @@
 
 #define LCD_DATA_PORT_ID	PORTC_ID		/*LCD Bi-directional DATA bus PORT ID for DATA and COMMANDS*/
 
+/*
+ * Set to 1 when the RW pin is wired to the MCU: the driver then reads the busy
+ * flag and continues as soon as the LCD is ready. With RW tied to ground the
+ * driver waits the worst case execution time of every instruction instead.
+ */
+#define LCD_RW_CONNECTED	0
+
+#if (LCD_RW_CONNECTED == 1)
+#define LCD_RW_PORT_ID		PORTD_ID		/*READ/WRITE PORT ID*/
+#define LCD_RW_PIN_ID		PIN6_ID			/*READ/WRITE PIN ID */
+#endif
+
 #if (LCD_DATA_BITS_MODE == 4)
 
 /*The first pin in the nibble connected to the LCD */
@@ -50,6 +74,49 @@
 
 #endif
 
+/*
+ * Port registers of the pins above: the bus path writes RS, E and the data
+ * directly instead of going through the GPIO driver port switch.
+ * They must be kept in sync with the port ids.
+ */
+#define LCD_RS_PORT_REG		PORTD
+#define LCD_E_PORT_REG		PORTD
+#define LCD_DATA_PORT_REG	PORTC
+
+/*
+ * HD44780 timing (fosc = 270 kHz) used when the busy flag can't be read,
+ * rounded up for the slowest modules.
+ */
+#define LCD_EXECUTION_TIME_US		50		/*most instructions and data writes: 37 us*/
+#define LCD_CLEAR_HOME_TIME_US		2000	/*clear display and return home: 1.52 ms*/
+#define LCD_INIT_COMMAND_DELAY_MS	5		/*function set before the interface is configured: 4.1 ms*/
+#define LCD_ENABLE_HIGH_NS			250		/*enable pulse width: 230 ns, covers data setup (80 ns) and read delay (160 ns)*/
+#define LCD_ENABLE_LOW_NS			250		/*enable cycle time: 500 ns, covers data hold (10 ns)*/
+
+/*
+ * After LCD_init, commands, data and delays are queued and written by the
+ * system tick, callers only wait when the queue is full.
+ * Every tick writes one entry, the tick period covers its execution time,
+ * clear display and return home hold the queue for the next ticks.
+ */
+#define LCD_QUEUE_SIZE				64		/*entries, must be a power of 2*/
+#define LCD_CLEAR_HOME_TICKS		2		/*ticks skipped after clear display / return home*/
+
+/*
+ * A marquee scrolls a string longer than a row through it: the tick renders each
+ * step in the shadow buffer and writes the changed cells in the ticks the queue leaves free.
+ */
+#define LCD_MARQUEE_GAP				4		/*spaces between the end of the string and its next pass*/
+
+/*
+ * Custom 5x8 characters: CGRAM holds 8 of them, displayed as the characters 0 to 7.
+ * The progress bar takes the first 5, a cell filled with n columns shows character n-1.
+ */
+#define LCD_NUM_OF_GLYPHS				8
+#define LCD_GLYPH_ROWS					8
+#define LCD_PROGRESS_FIRST_GLYPH		0
+#define LCD_PROGRESS_STEPS_PER_CELL		5
+
 /*LCD commands*/
 #define LCD_DISPLAY_OFF							0x08
 #define LCD_CLEAR_DISPLAY 						0x01
@@ -58,6 +125,7 @@
 #define LCD_CURSOR_BLINK						0x0F
 #define LCD_CURSOR_GO_HOME						0x02
 #define LCD_SET_CURSOR_LOCATION     			0x80
+#define LCD_SET_CGRAM_ADDRESS					0x40
 #define LCD_SHIFT_DISPLAY_LEFT					0x18
 #define LCD_SHIFT_DISPLAY_RIGHT					0x1C
 #define LCD_EIGHT_BITS_MODE						0x38
@@ -105,15 +173,30 @@ void LCD_displayString(const uint8 * strConst);
 
 /*
  * Description :
- * display a given data briefly, then replace it with a given symbol
+ * Display the required string stored in flash (PROGMEM) on the screen
+ */
+void LCD_displayStringPgm(const uint8 * strFlash);
+
+
+/*
+ * Description :
+ * display a given data briefly, then replace it with a given symbol.
+ * The replacement is queued behind a delay, the function does not wait.
  */
 void LCD_characterFade(uint8 a_data, uint8 a_symbol);
 /*
  * Description :
- * write the required string on the screen with delay effect
+ * write the required string on the screen with delay effect,
+ * the delays are queued between the characters, the function does not wait.
  */
 void LCD_writeString(const uint8 * strConst, const uint16 a_writeDelay_ms);
 
+/*
+ * Description :
+ * write the required string stored in flash (PROGMEM) on the screen with delay effect
+ */
+void LCD_writeStringPgm(const uint8 * strFlash, const uint16 a_writeDelay_ms);
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
@@ -126,6 +209,12 @@ void LCD_moveCursor(uint8 row, uint8 col);
  */
 void LCD_displayStringRowColumn(uint8 row, uint8 col, const uint8 * str);
 
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumnPgm(uint8 row, uint8 col, const uint8 * strFlash);
+
 /*
  * Description :
  * Display the required decimal value on the screen
@@ -138,6 +227,86 @@ void LCD_intgerToString(int data);
  */
 void LCD_clearScreen(void);
 
+/*
+ * Description :
+ * Return TRUE when every queued command, data byte and delay has been executed.
+ */
+boolean LCD_isIdle(void);
+
+/*
+ * Description :
+ * Fill the shadow buffer with spaces and stop the marquees, the screen is not touched until LCD_flush.
+ */
+void LCD_bufferClear(void);
+
+/*
+ * Description :
+ * Write a character in the shadow buffer only.
+ */
+void LCD_bufferWriteCharacter(uint8 row, uint8 col, uint8 data);
+
+/*
+ * Description :
+ * Write a string in the shadow buffer only, starting at a row and column index.
+ */
+void LCD_bufferWriteString(uint8 row, uint8 col, const uint8 * str);
+
+/*
+ * Description :
+ * Write a string stored in flash (PROGMEM) in the shadow buffer only.
+ */
+void LCD_bufferWriteStringPgm(uint8 row, uint8 col, const uint8 * strFlash);
+
+/*
+ * Description :
+ * Write a string stored in flash (PROGMEM) in a field of width cells of the shadow buffer:
+ * a longer string is cut, a shorter one is padded with spaces.
+ */
+void LCD_bufferWriteFieldPgm(uint8 row, uint8 col, const uint8 * strFlash, uint8 width);
+
+/*
+ * Description :
+ * Bring the screen up to date with the shadow buffer: only the cells that differ
+ * from the LCD contents are written, one cursor move per run of changed cells.
+ */
+void LCD_flush(void);
+
+/*
+ * Description :
+ * Scroll a string stored in flash (PROGMEM) through a row, one column every step time.
+ * The row belongs to the marquee until it is stopped: LCD_flush leaves it alone.
+ * A string that fits in the row is displayed without scrolling.
+ */
+void LCD_marqueeStartPgm(uint8 row, const uint8 * strFlash, uint16 a_stepTime_ms);
+
+/*
+ * Description :
+ * Stop the marquee of a row, its last step stays in the shadow buffer and
+ * LCD_flush writes the row again.
+ * LCD_bufferClear and LCD_clearScreen stop all the marquees.
+ */
+void LCD_marqueeStop(uint8 row);
+
+/*
+ * Description :
+ * Load a custom character (8 rows of 5 bits, first row first) stored in flash (PROGMEM)
+ * into CGRAM, it is displayed by writing its index (0 to 7) as a character.
+ */
+void LCD_loadGlyphPgm(uint8 a_index, const uint8 * patternFlash);
+
+/*
+ * Description :
+ * Load the partial-fill characters used by the progress bar.
+ */
+void LCD_progressBarInit(void);
+
+/*
+ * Description :
+ * Draw a progress bar in the shadow buffer only, width cells starting at a row and column index.
+ * Each cell has 5 steps, so LCD_flush only writes the cell whose fill changed.
+ */
+void LCD_bufferProgressBar(uint8 row, uint8 col, uint8 width, uint8 a_percent);
+
 /*
  * Description :
  * Shift the display in the specified direction each time delay time is elapsed
@@ -0,0 +1,250 @@
+/******************************************************************************
+ * [FILE NAME]:     lcd_format.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the LCD number formatting
+ *******************************************************************************/
+
+#include "lcd_format.h"
+#include "lcd.h"
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                     	   	  Global Variables                                 *
+ *******************************************************************************/
+
+/*
+ * The two characters of every value from 00 to 99: one division by 100
+ * gives two digits instead of one division by 10 per digit.
+ */
+static const uint8 g_digitPairs[200] PROGMEM =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+static const uint8 g_hexDigits[16] PROGMEM = "0123456789ABCDEF";
+
+static const uint16 g_powersOfTen[LCD_FORMAT_MAX_DIGITS] PROGMEM =
+{
+		1, 10, 100, 1000, 10000
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static uint8 LCD_countDigits(uint16 a_value);
+static void LCD_writeDigitsBackward(uint8 a_row, uint8 a_endCol, uint16 a_value);
+static void LCD_fillCells(uint8 a_row, uint8 a_col, uint8 a_count, uint8 a_data);
+
+/*******************************************************************************
+ *                     		 Functions Definitions                             *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Number of decimal digits of a value, by comparison only.
+ */
+static uint8 LCD_countDigits(uint16 a_value){
+	uint8 digits = 1;
+
+	while(digits < LCD_FORMAT_MAX_DIGITS && a_value >= pgm_read_word(&g_powersOfTen[digits])){
+		digits++;
+	}
+	return digits;
+}
+
+/*
+ * Description :
+ * Write the digits of a value in the cells before a_endCol, least significant first.
+ * The caller reserves LCD_countDigits(a_value) cells.
+ */
+static void LCD_writeDigitsBackward(uint8 a_row, uint8 a_endCol, uint16 a_value){
+	uint8 pair;
+
+	while(a_value >= 100){
+		pair = a_value % 100;
+		a_value /= 100;
+		LCD_bufferWriteCharacter(a_row, --a_endCol, pgm_read_byte(&g_digitPairs[2 * pair + 1]));
+		LCD_bufferWriteCharacter(a_row, --a_endCol, pgm_read_byte(&g_digitPairs[2 * pair]));
+	}
+
+	if(a_value >= 10){
+		LCD_bufferWriteCharacter(a_row, --a_endCol, pgm_read_byte(&g_digitPairs[2 * a_value + 1]));
+		LCD_bufferWriteCharacter(a_row, --a_endCol, pgm_read_byte(&g_digitPairs[2 * a_value]));
+	}
+	else{
+		LCD_bufferWriteCharacter(a_row, --a_endCol, '0' + a_value);
+	}
+}
+
+static void LCD_fillCells(uint8 a_row, uint8 a_col, uint8 a_count, uint8 a_data){
+	while(a_count != 0){
+		LCD_bufferWriteCharacter(a_row, a_col++, a_data);
+		a_count--;
+	}
+}
+
+/*
+ * Description :
+ * Write an unsigned value right aligned in a field of width cells,
+ * padded on the left with a_pad (' ' or '0').
+ * Returns the number of cells used.
+ */
+uint8 LCD_bufferWriteUnsigned(uint8 row, uint8 col, uint16 value, uint8 width, uint8 a_pad){
+	uint8 digits = LCD_countDigits(value);
+
+	if(width == 0){
+		width = digits;
+	}
+	else if(digits > width){
+		LCD_fillCells(row, col, width, LCD_FORMAT_OVERFLOW_CHAR);
+		return width;
+	}
+
+	LCD_fillCells(row, col, width - digits, a_pad);
+	LCD_writeDigitsBackward(row, col + width, value);
+	return width;
+}
+
+/*
+ * Description :
+ * Write a signed value right aligned in a field of width cells, the minus sign
+ * goes before the padding zeros and after the padding spaces.
+ * Returns the number of cells used.
+ */
+uint8 LCD_bufferWriteSigned(uint8 row, uint8 col, sint16 value, uint8 width, uint8 a_pad){
+	uint16 magnitude;
+	uint8 digits;
+
+	if(value >= 0){
+		return LCD_bufferWriteUnsigned(row, col, value, width, a_pad);
+	}
+
+	magnitude = (uint16)(-(sint32)value);
+	digits = LCD_countDigits(magnitude) + 1;
+
+	if(width == 0){
+		width = digits;
+	}
+	else if(digits > width){
+		LCD_fillCells(row, col, width, LCD_FORMAT_OVERFLOW_CHAR);
+		return width;
+	}
+
+	if(a_pad == '0'){
+		LCD_bufferWriteCharacter(row, col, '-');
+		LCD_fillCells(row, col + 1, width - digits, '0');
+	}
+	else{
+		LCD_fillCells(row, col, width - digits, a_pad);
+		LCD_bufferWriteCharacter(row, col + width - digits, '-');
+	}
+	LCD_writeDigitsBackward(row, col + width, magnitude);
+	return width;
+}
+
+/*
+ * Description :
+ * Write a fixed-point value (value / 10^decimals) right aligned in a field of width cells,
+ * e.g. 4980 with 3 decimals is written 4.980.
+ * Returns the number of cells used.
+ */
+uint8 LCD_bufferWriteFixed(uint8 row, uint8 col, uint16 value, uint8 decimals, uint8 width){
+	uint16 scale;
+	uint16 fraction;
+	uint8 digits;
+	uint8 end;
+
+	if(decimals == 0){
+		return LCD_bufferWriteUnsigned(row, col, value, width, ' ');
+	}
+	if(decimals > LCD_FORMAT_MAX_DECIMALS){
+		decimals = LCD_FORMAT_MAX_DECIMALS;
+	}
+
+	scale = pgm_read_word(&g_powersOfTen[decimals]);
+	fraction = value % scale;
+	value /= scale;
+
+	/*integer part, point and all the decimals*/
+	digits = LCD_countDigits(value) + 1 + decimals;
+
+	if(width == 0){
+		width = digits;
+	}
+	else if(digits > width){
+		LCD_fillCells(row, col, width, LCD_FORMAT_OVERFLOW_CHAR);
+		return width;
+	}
+
+	end = col + width;
+
+	/*the fraction keeps its leading zeros: 4.050 and not 4.50*/
+	LCD_fillCells(row, end - decimals, decimals - LCD_countDigits(fraction), '0');
+	LCD_writeDigitsBackward(row, end, fraction);
+	end -= decimals;
+
+	LCD_bufferWriteCharacter(row, --end, '.');
+	LCD_writeDigitsBackward(row, end, value);
+	LCD_fillCells(row, col, width - digits, ' ');
+	return width;
+}
+
+/*
+ * Description :
+ * Write the low hexadecimal digits (1 to 4) of a value, upper case with leading zeros.
+ */
+void LCD_bufferWriteHex(uint8 row, uint8 col, uint16 value, uint8 digits){
+	while(digits != 0){
+		digits--;
+		LCD_bufferWriteCharacter(row, col + digits, pgm_read_byte(&g_hexDigits[value & 0x0F]));
+		value >>= 4;
+	}
+}
+
+/*
+ * Description :
+ * Display a signed value at the cursor, most significant digit first:
+ * the value is cut in digit pairs from the top with the powers of ten.
+ */
+void LCD_displayDecimal(sint16 value){
+	uint16 magnitude;
+	uint16 power;
+	uint8 digits;
+	uint8 pair;
+
+	if(value < 0){
+		LCD_displayCharacter('-');
+		magnitude = (uint16)(-(sint32)value);
+	}
+	else{
+		magnitude = value;
+	}
+
+	digits = LCD_countDigits(magnitude);
+
+	/*an odd count starts with a single digit*/
+	if(digits & 0x01){
+		digits--;
+		power = pgm_read_word(&g_powersOfTen[digits]);
+		pair = magnitude / power;
+		magnitude -= pair * power;
+		LCD_displayCharacter('0' + pair);
+	}
+
+	while(digits != 0){
+		digits -= 2;
+		power = pgm_read_word(&g_powersOfTen[digits]);
+		pair = magnitude / power;
+		magnitude -= pair * power;
+		LCD_displayCharacter(pgm_read_byte(&g_digitPairs[2 * pair]));
+		LCD_displayCharacter(pgm_read_byte(&g_digitPairs[2 * pair + 1]));
+	}
+}
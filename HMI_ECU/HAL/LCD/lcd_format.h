@@ -0,0 +1,66 @@
+/******************************************************************************
+ * [FILE NAME]:     lcd_format.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the LCD number formatting
+ *******************************************************************************/
+
+#ifndef LCD_FORMAT_H_
+#define LCD_FORMAT_H_
+
+#include "../../Utils/std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+#define LCD_FORMAT_MAX_DIGITS		5		/*decimal digits of a 16-bit value*/
+#define LCD_FORMAT_MAX_DECIMALS		4		/*fractional digits of a fixed-point value*/
+#define LCD_FORMAT_OVERFLOW_CHAR	'*'		/*fills a field too narrow for its value*/
+
+/*
+ * The numbers are written in the shadow buffer right to left from the end of
+ * their field, so no string is built on the way: they are shown by the next LCD_flush.
+ * A width of 0 takes as many cells as the value needs.
+ */
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Write an unsigned value right aligned in a field of width cells,
+ * padded on the left with a_pad (' ' or '0').
+ * Returns the number of cells used.
+ */
+uint8 LCD_bufferWriteUnsigned(uint8 row, uint8 col, uint16 value, uint8 width, uint8 a_pad);
+
+/*
+ * Description :
+ * Write a signed value right aligned in a field of width cells, the minus sign
+ * goes before the padding zeros and after the padding spaces.
+ * Returns the number of cells used.
+ */
+uint8 LCD_bufferWriteSigned(uint8 row, uint8 col, sint16 value, uint8 width, uint8 a_pad);
+
+/*
+ * Description :
+ * Write a fixed-point value (value / 10^decimals) right aligned in a field of width cells,
+ * e.g. 4980 with 3 decimals is written 4.980.
+ * Returns the number of cells used.
+ */
+uint8 LCD_bufferWriteFixed(uint8 row, uint8 col, uint16 value, uint8 decimals, uint8 width);
+
+/*
+ * Description :
+ * Write the low hexadecimal digits (1 to 4) of a value, upper case with leading zeros.
+ */
+void LCD_bufferWriteHex(uint8 row, uint8 col, uint16 value, uint8 digits);
+
+/*
+ * Description :
+ * Display a signed value at the cursor, most significant digit first.
+ */
+void LCD_displayDecimal(sint16 value);
+
+#endif /* LCD_FORMAT_H_ */
@@ -0,0 +1,30 @@
+/******************************************************************************
+ * [FILE NAME]:     power.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the sleep modes
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "power.h"
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+void POWER_sleepWhile(POWER_SleepMode a_mode, volatile boolean * a_asleep){
+	set_sleep_mode((a_mode == POWER_DOWN) ? SLEEP_MODE_PWR_DOWN : SLEEP_MODE_IDLE);
+
+	cli();
+	while(*a_asleep){
+		sleep_enable();
+		/*the instruction after sei is executed before any interrupt: no wake-up is lost*/
+		sei();
+		sleep_cpu();
+		sleep_disable();
+		cli();
+	}
+	sei();
+}
@@ -0,0 +1,39 @@
+/******************************************************************************
+ * [FILE NAME]:     power.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the sleep modes
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#include "../../Utils/std_types.h"
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*
+ * Idle stops the CPU only, every interrupt wakes it.
+ * Power-down also stops the clock and timer2 (so the system tick): only an
+ * external interrupt, TWI address match or the watchdog wakes it.
+ */
+typedef enum{
+	POWER_IDLE, POWER_DOWN
+}POWER_SleepMode;
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Sleep in the given mode as long as *a_asleep is TRUE, the ISR that wakes
+ * the MCU clears it. The flag is checked with the interrupts disabled up to
+ * the sleep instruction, so a wake-up interrupt cannot be missed.
+ * Interrupts are enabled on return.
+ */
+void POWER_sleepWhile(POWER_SleepMode a_mode, volatile boolean * a_asleep);
+
+#endif /* POWER_H_ */
@@ -0,0 +1,168 @@
+/******************************************************************************
+ * [FILE NAME]:     profiler.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for the execution time profiler
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include "profiler.h"
+
+#if (PROF_ENABLED == 1)
+
+#include "../USART/usart.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+volatile uint16 g_profStart[PROF_NUM_OF_PROBES];
+
+static PROF_Stats g_profStats[PROF_NUM_OF_PROBES];
+
+/*report names of the probes, kept in flash*/
+#define PROF_NAME_STRING(NAME)	static const char g_profName_##NAME[] PROGMEM = #NAME;
+PROF_PROBE_LIST(PROF_NAME_STRING)
+
+#define PROF_NAME_ENTRY(NAME)	g_profName_##NAME,
+static const char * const g_profNames[PROF_NUM_OF_PROBES] PROGMEM =
+{
+		PROF_PROBE_LIST(PROF_NAME_ENTRY)
+};
+
+static const TIMER_ConfigType g_profTimerConfig =
+{
+		.timer_id = TIMER1_ID,
+		.timer_mode = OVERFLOW_MODE,
+		.timer_prescaler.timer1 = PROF_PRESCALER,
+		.timer_ocx_pin_behavior = DISCONNECT_OCX,
+		.timer_mode_data.ovf_initial_value = 0,
+};
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+static void PROF_sendStringP(const char * a_str);
+static void PROF_sendNumber(uint32 a_number);
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+void PROF_init(void){
+	uint8 i;
+
+	for(i = 0; i < PROF_NUM_OF_PROBES; i++){
+		g_profStats[i].min = 0xFFFF;
+		g_profStats[i].max = 0;
+		g_profStats[i].total = 0;
+		g_profStats[i].count = 0;
+	}
+
+	/*timer1 counts freely from 0 to 0xFFFF, the probes only read it*/
+	TIMER_claimChannel(TIMER_CLIENT_PROFILER, TIMER1_CHANNEL_OVF, &g_profTimerConfig);
+}
+
+/*
+ * Reading a 16-bit timer register goes through the shared TEMP register,
+ * so a read from the main context must not be interrupted by an ISR probe.
+ */
+uint16 PROF_readCounter(void){
+	uint16 count;
+	uint8 sreg = SREG;
+
+	cli();
+	count = TCNT1;
+	SREG = sreg;
+
+	return count;
+}
+
+void PROF_record(PROF_Id a_id, uint16 a_counts){
+	PROF_Stats * stats = &g_profStats[a_id];
+	uint8 sreg = SREG;
+
+	/*the same probe may be ended from the main context while an ISR probe records*/
+	cli();
+	if(a_counts < stats->min){
+		stats->min = a_counts;
+	}
+	if(a_counts > stats->max){
+		stats->max = a_counts;
+	}
+	/*the total stops with the saturated count so the average stays right*/
+	if(stats->count != 0xFFFF){
+		stats->total += a_counts;
+		stats->count++;
+	}
+	SREG = sreg;
+}
+
+void PROF_getStats(PROF_Id a_id, PROF_Stats * a_stats){
+	uint8 sreg = SREG;
+
+	cli();
+	*a_stats = g_profStats[a_id];
+	SREG = sreg;
+}
+
+void PROF_report(void){
+	PROF_Stats stats;
+	uint8 i;
+
+	PROF_sendStringP(PSTR("PROFILE (1 count = "));
+	PROF_sendNumber(PROF_CYCLES_PER_COUNT);
+	PROF_sendStringP(PSTR(" cycles)\r\nprobe count min max avg\r\n"));
+
+	for(i = 0; i < PROF_NUM_OF_PROBES; i++){
+		PROF_getStats(i, &stats);
+		if(stats.count == 0){
+			continue;	/*probe never hit*/
+		}
+		PROF_sendStringP((const char *)pgm_read_word(&g_profNames[i]));
+		USART_sendByte(' ');
+		PROF_sendNumber(stats.count);
+		USART_sendByte(' ');
+		PROF_sendNumber(stats.min);
+		USART_sendByte(' ');
+		PROF_sendNumber(stats.max);
+		USART_sendByte(' ');
+		PROF_sendNumber(stats.total / stats.count);
+		PROF_sendStringP(PSTR("\r\n"));
+	}
+}
+
+/*
+ * Description :
+ * Send a null terminated string stored in flash.
+ */
+static void PROF_sendStringP(const char * a_str){
+	uint8 character;
+
+	while((character = pgm_read_byte(a_str++)) != '\0'){
+		USART_sendByte(character);
+	}
+}
+
+/*
+ * Description :
+ * Send an unsigned number in decimal.
+ */
+static void PROF_sendNumber(uint32 a_number){
+	uint8 digits[10];
+	uint8 i = 0;
+
+	do{
+		digits[i++] = '0' + (a_number % 10);
+		a_number /= 10;
+	}while(a_number != 0);
+
+	while(i != 0){
+		USART_sendByte(digits[--i]);
+	}
+}
+
+#endif /* PROF_ENABLED */
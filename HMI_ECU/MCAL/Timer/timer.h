@@ -18,7 +18,44 @@
 #define TIMER0_MAX_COUNT 255
 #define TIMER1_MAX_COUNT 65536
 #define TIMER2_MAX_COUNT 255
-#define TOP_VALUE 4783
+#define TOP_VALUE 4783	/*TOP (ICR1) of the timer1 PWM modes when the configuration does not give one*/
+
+/*
+ * Capacity of the subscriber table of every timer event.
+ * The dispatch cost of an event is bounded by its capacity.
+ */
+#define TIMER0_OVF_MAX_SUBSCRIBERS		1
+#define TIMER0_COMP_MAX_SUBSCRIBERS		1
+#define TIMER1_OVF_MAX_SUBSCRIBERS		2
+#define TIMER1_COMPA_MAX_SUBSCRIBERS	2
+#define TIMER1_COMPB_MAX_SUBSCRIBERS	1
+#define TIMER1_CAPT_MAX_SUBSCRIBERS		1
+#define TIMER2_OVF_MAX_SUBSCRIBERS		1
+#define TIMER2_COMP_MAX_SUBSCRIBERS		6
+
+/*both PWM modes have bit 0 of TIMER_Mode set*/
+#define TIMER_IS_PWM_MODE(mode)		((mode) & 0x01)
+
+/*
+ * Compare values of a duty cycle, computed by the compiler when top and the
+ * duty cycle are constants. TIMER_DUTY_PERCENT_TABLE(top) expands to the 101
+ * compare values of 0..100 % to fill a table in flash, so a duty cycle update
+ * at run time is a table read and a single OCR write (TIMER_changeDutyCount).
+ */
+#define TIMER_DUTY_PERCENT(top, percent)	((uint16)(((uint32)(top) * (percent) + 50) / 100))
+#define TIMER_DUTY_PERMILLE(top, permille)	((uint16)(((uint32)(top) * (permille) + 500) / 1000))
+
+#define TIMER_DUTY_PERCENT_ROW(top, tens)	\
+	TIMER_DUTY_PERCENT(top, (tens) + 0), TIMER_DUTY_PERCENT(top, (tens) + 1), TIMER_DUTY_PERCENT(top, (tens) + 2),\
+	TIMER_DUTY_PERCENT(top, (tens) + 3), TIMER_DUTY_PERCENT(top, (tens) + 4), TIMER_DUTY_PERCENT(top, (tens) + 5),\
+	TIMER_DUTY_PERCENT(top, (tens) + 6), TIMER_DUTY_PERCENT(top, (tens) + 7), TIMER_DUTY_PERCENT(top, (tens) + 8),\
+	TIMER_DUTY_PERCENT(top, (tens) + 9)
+
+#define TIMER_DUTY_PERCENT_TABLE(top)	\
+	TIMER_DUTY_PERCENT_ROW(top, 0),  TIMER_DUTY_PERCENT_ROW(top, 10), TIMER_DUTY_PERCENT_ROW(top, 20),\
+	TIMER_DUTY_PERCENT_ROW(top, 30), TIMER_DUTY_PERCENT_ROW(top, 40), TIMER_DUTY_PERCENT_ROW(top, 50),\
+	TIMER_DUTY_PERCENT_ROW(top, 60), TIMER_DUTY_PERCENT_ROW(top, 70), TIMER_DUTY_PERCENT_ROW(top, 80),\
+	TIMER_DUTY_PERCENT_ROW(top, 90), TIMER_DUTY_PERCENT(top, 100)
 
 #define OC0 	PB3
 #define OC1B 	PD4
@@ -33,6 +70,25 @@ typedef enum{
 	TIMER0_ID, TIMER1_ID, TIMER2_ID,
 }TIMER_ID;
 
+/*
+ * Units of a timer that can be handed out to a client independently.
+ * All channels of the same timer share its base (mode, pre-scaler and TOP).
+ */
+typedef enum{
+	TIMER0_CHANNEL_OVF, TIMER0_CHANNEL_OC0,
+	TIMER1_CHANNEL_OVF, TIMER1_CHANNEL_OC1A, TIMER1_CHANNEL_OC1B, TIMER1_CHANNEL_ICP,
+	TIMER2_CHANNEL_OVF, TIMER2_CHANNEL_OC2,
+	TIMER_NUM_OF_CHANNELS
+}TIMER_Channel;
+
+/*Interrupt events that modules can subscribe to*/
+typedef enum{
+	TIMER0_EVENT_OVF, TIMER0_EVENT_COMP,
+	TIMER1_EVENT_OVF, TIMER1_EVENT_COMPA, TIMER1_EVENT_COMPB, TIMER1_EVENT_CAPT,
+	TIMER2_EVENT_OVF, TIMER2_EVENT_COMP,
+	TIMER_NUM_OF_EVENTS
+}TIMER_Event;
+
 /*Pre-scaler definitions for timer 0*/
 typedef enum{
 	TIMER0_NO_CLK, TIMER0_F_CPU_1, TIMER0_F_CPU_8, TIMER0_F_CPU_64, TIMER0_F_CPU_256, TIMER0_F_CPU_1024,
@@ -51,8 +107,13 @@ typedef enum{
 	TIMER2_F_CPU_256, TIMER2_F_CPU_1024
 }TIMER2_Prescaler;
 
+/*
+ * The value is the waveform generation bits of the mode:
+ * phase correct PWM counts up and down (half the frequency of the fast PWM,
+ * symmetric pulses), on timer1 both PWM modes use ICR1 as TOP.
+ */
 typedef enum{
-	OVERFLOW_MODE, COMPARE_MODE = 2, PWM_MODE
+	OVERFLOW_MODE, PWM_PHASE_CORRECT_MODE, COMPARE_MODE, PWM_MODE
 }TIMER_Mode;
 
 typedef enum{
@@ -68,7 +129,7 @@ typedef enum{
 typedef union{
 	uint16 ovf_initial_value;		/*Overflow Mode*/
 	uint16 ctc_compare_value;		/*CTC Mode*/
-	uint8  pwm_duty_cycle;			/*FAST PWM mode*/
+	uint8  pwm_duty_cycle;			/*PWM modes (percentage)*/
 }TIMER_ModeData;
 
 /*A union containing the pre-scalers for timers (timer2 has a wider pre-scaling range)*/
@@ -85,15 +146,62 @@ typedef struct{
 	TIMER_GeneralPrescaler timer_prescaler;
 	TIMER_CompareOutput timer_ocx_pin_behavior;
 	TIMER1_OutputPinSelect timer1_pwm_pin_select; /*Special config. for timer1 to select compare output pins*/
+	uint16 timer1_pwm_top;	/*Special config. for timer1 PWM modes: TOP (ICR1), 0 selects TOP_VALUE*/
 }TIMER_ConfigType;
 
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
 
+/*
+ * Description :
+ * Configure the timer base and the channel implied by the configuration:
+ * the overflow channel in overflow mode, OC0/OC2/OC1A in compare mode and the
+ * selected output pin in PWM mode.
+ */
 void TIMER_init(TIMER_ConfigType * a_timerConfig);
+
+/*
+ * Description :
+ * Configure only the timer base (waveform mode and pre-scaler), all channels are left disabled.
+ */
+void TIMER_initBase(const TIMER_ConfigType * a_timerConfig);
+
+/*
+ * Description :
+ * Enable a single channel of an already running timer without touching its counter.
+ */
+void TIMER_setupChannel(TIMER_Channel a_channel, const TIMER_ConfigType * a_timerConfig);
+
+/*
+ * Description :
+ * Disconnect the output pin and disable the interrupt of a single channel.
+ */
+void TIMER_disableChannel(TIMER_Channel a_channel);
+
 void TIMER_deInit(TIMER_ID a_timerId);
-void TIMER_setCallBackFunc(TIMER_ID a_timerId, void volatile (*a_functionAddressPtr) (void));
+/*
+ * Description :
+ * Add a callback to the subscriber table of a timer event.
+ * The callback is called from the ISR once every a_divisor events (1 = every event).
+ * Returns FALSE if the table of the event is full.
+ */
+boolean TIMER_subscribe(TIMER_Event a_event, void (*a_callback)(void), uint16 a_divisor);
+
+/*
+ * Description :
+ * Remove a callback from the subscriber table of a timer event.
+ */
+void TIMER_unsubscribe(TIMER_Event a_event, void (*a_callback)(void));
+
 void TIMER_changeCompareValue(TIMER_ID a_timerId, uint16 a_new_vlaue);
+void TIMER_changeDutyCycle(TIMER_ConfigType * a_timerConfig);
+
+/*
+ * Description :
+ * Write a precomputed compare value (see TIMER_DUTY_PERCENT_TABLE) to the
+ * compare register of a PWM channel, no arithmetic is done at run time.
+ */
+void TIMER_changeDutyCount(TIMER_Channel a_channel, uint16 a_count);
 
 #endif /* TIMER_H_ */
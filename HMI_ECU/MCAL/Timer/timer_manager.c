@@ -0,0 +1,101 @@
+/******************************************************************************
+ * [FILE NAME]:     timer_manager.c
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Source file for Timer resource manager
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#include "timer_manager.h"
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/*the timer each channel belongs to*/
+static const TIMER_ID g_channelTimer[TIMER_NUM_OF_CHANNELS] =
+{
+		TIMER0_ID, TIMER0_ID,
+		TIMER1_ID, TIMER1_ID, TIMER1_ID, TIMER1_ID,
+		TIMER2_ID, TIMER2_ID
+};
+
+static TIMER_Client g_channelOwner[TIMER_NUM_OF_CHANNELS] = {TIMER_CLIENT_NONE};
+
+/*number of claimed channels and the base each running timer was started with*/
+static uint8 g_timerUsers[3] = {0};
+static TIMER_Mode g_timerMode[3];
+static uint8 g_timerPrescaler[3];
+static uint16 g_timer1PwmTop;
+
+/*******************************************************************************
+ *                    	  Functions Definitions                                *
+ *******************************************************************************/
+
+TIMER_ClaimStatus TIMER_claimChannel(TIMER_Client a_client, TIMER_Channel a_channel, const TIMER_ConfigType * a_timerConfig){
+	TIMER_ID timer;
+	uint8 prescaler;
+	uint16 pwm_top;
+
+	if(a_channel >= TIMER_NUM_OF_CHANNELS || a_timerConfig->timer_id != g_channelTimer[a_channel]){
+		return TIMER_CLAIM_CONFLICT;
+	}
+
+	timer = g_channelTimer[a_channel];
+	prescaler = (uint8)a_timerConfig->timer_prescaler.timer1; /*the pre-scaler enums share the same byte*/
+	pwm_top = (a_timerConfig->timer1_pwm_top != 0) ? a_timerConfig->timer1_pwm_top : TOP_VALUE; /*the TOP programmed in ICR1*/
+
+	if(g_channelOwner[a_channel] != TIMER_CLIENT_NONE && g_channelOwner[a_channel] != a_client){
+		return TIMER_CLAIM_BUSY;
+	}
+
+	if(g_timerUsers[timer] == 0){
+		/*first user decides the base of the timer*/
+		TIMER_initBase(a_timerConfig);
+		g_timerMode[timer] = a_timerConfig->timer_mode;
+		g_timerPrescaler[timer] = prescaler;
+		if(timer == TIMER1_ID){
+			g_timer1PwmTop = pwm_top;	/*a timer0/2 claim leaves the TOP of timer1 alone*/
+		}
+	}
+	else if(g_timerMode[timer] != a_timerConfig->timer_mode || g_timerPrescaler[timer] != prescaler){
+		return TIMER_CLAIM_CONFLICT;
+	}
+	else if(timer == TIMER1_ID && TIMER_IS_PWM_MODE(g_timerMode[timer]) && g_timer1PwmTop != pwm_top){
+		return TIMER_CLAIM_CONFLICT;	/*the PWM channels of timer1 share its TOP*/
+	}
+
+	/*a client re-claiming its own channel only reconfigures it*/
+	if(g_channelOwner[a_channel] == TIMER_CLIENT_NONE){
+		g_channelOwner[a_channel] = a_client;
+		g_timerUsers[timer]++;
+	}
+
+	TIMER_setupChannel(a_channel, a_timerConfig);
+
+	return TIMER_CLAIM_OK;
+}
+
+void TIMER_releaseChannel(TIMER_Client a_client, TIMER_Channel a_channel){
+	TIMER_ID timer;
+
+	if(a_channel >= TIMER_NUM_OF_CHANNELS || g_channelOwner[a_channel] != a_client){
+		return;
+	}
+
+	timer = g_channelTimer[a_channel];
+
+	TIMER_disableChannel(a_channel);
+	g_channelOwner[a_channel] = TIMER_CLIENT_NONE;
+	g_timerUsers[timer]--;
+
+	if(g_timerUsers[timer] == 0){
+		TIMER_deInit(timer);	/*stop the clock once nobody uses the timer*/
+	}
+}
+
+TIMER_Client TIMER_getChannelOwner(TIMER_Channel a_channel){
+	if(a_channel >= TIMER_NUM_OF_CHANNELS){
+		return TIMER_CLIENT_NONE;
+	}
+	return g_channelOwner[a_channel];
+}
@@ -115,10 +115,38 @@ void USART_sendByte(uint8 a_data);
  */
 uint8 USART_receiveByte(void);
 
+/*
+ * Description :
+ * Read a received byte if there is one, without waiting.
+ * Returns FALSE when nothing was received.
+ */
+boolean USART_tryReceiveByte(uint8 * const a_data);
+
+/*
+ * Description :
+ * Wait up to a_timeout_ms for a byte from the other UART device.
+ * Returns FALSE if nothing was received in time.
+ */
+boolean USART_receiveByteFor(uint8 * const a_data, uint16 a_timeout_ms);
+
+/*
+ * Description :
+ * Send the required string through UART to the other UART device.
+ */
+void USART_sendString(const uint8 * a_txStrPtr);
+
 /*
  * Description :
  * Receive the required string until the terminator symbol.
  */
 void USART_receiveString(uint8 * const a_rxStrPtr);
 
+/*
+ * Description :
+ * Receive a string until the terminator symbol into a buffer of a_size bytes,
+ * waiting up to a_timeout_ms for each character.
+ * Returns FALSE on a timeout or if the string does not fit.
+ */
+boolean USART_receiveStringFor(uint8 * const a_rxStrPtr, uint8 a_size, uint16 a_timeout_ms);
+
 #endif /*USART_H_*/
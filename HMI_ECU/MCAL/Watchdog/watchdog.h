@@ -0,0 +1,93 @@
+/******************************************************************************
+ * [FILE NAME]:     watchdog.h
+ * [AUTHOR]:        Marwan Shehata
+ * [Description]:   Header file for the watchdog supervision service
+ * [TARGET HW]:		ATmega32
+ *******************************************************************************/
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include "../../Utils/std_types.h"
+#include "../../Utils/common_macros.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * The hardware watchdog resets the MCU ~2.1 seconds after the last kick.
+ * The supervisor runs from the system tick and only kicks it when every task
+ * has checked in since the previous kick, so each task must check in more often
+ * than the hardware timeout.
+ */
+#define WDG_SUPERVISION_PERIOD_MS	250
+
+/*MCUCSR reset flags*/
+#define WDG_PORF		0
+#define WDG_EXTRF		1
+#define WDG_BORF		2
+#define WDG_WDRF		3
+#define WDG_JTRF		4
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+
+/*Loops that have to prove they are still running*/
+typedef enum{
+	WDG_TASK_MAIN,		/*main loop and every blocking wait of the application*/
+	WDG_NUM_OF_TASKS
+}WDG_Task;
+
+typedef enum{
+	WDG_RESET_POWER_ON, WDG_RESET_EXTERNAL, WDG_RESET_BROWN_OUT, WDG_RESET_WATCHDOG, WDG_RESET_JTAG
+}WDG_ResetCause;
+
+/*******************************************************************************
+ *                           Check-in Macro                                    *
+ *******************************************************************************/
+
+extern volatile uint8 g_wdgAlive[WDG_NUM_OF_TASKS];
+
+/*a single byte store, cheap enough for the innermost wait loops*/
+#define WDG_checkIn(task)	(g_wdgAlive[(task)] = TRUE)
+
+/*******************************************************************************
+ *                              Functions Prototypes                           *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * 1. Read and clear the reset flags in MCUCSR (must be called early at boot).
+ * 2. Start the hardware watchdog.
+ * 3. Subscribe the supervisor to the system tick.
+ */
+void WDG_init(void);
+
+/*
+ * Description :
+ * Stop the hardware watchdog before a sleep mode that stops the system tick,
+ * it would reset the MCU before the wake-up otherwise.
+ */
+void WDG_suspend(void);
+
+/*
+ * Description :
+ * Restart the hardware watchdog stopped by WDG_suspend.
+ */
+void WDG_resume(void);
+
+/*
+ * Description :
+ * Return the cause of the last reset as read by WDG_init.
+ */
+WDG_ResetCause WDG_getResetCause(void);
+
+/*
+ * Description :
+ * Return the raw MCUCSR reset flags read by WDG_init.
+ */
+uint8 WDG_getResetFlags(void);
+
+#endif /* WATCHDOG_H_ */
@@ -21,46 +21,64 @@ int main(void)
 			.usart_parity = PARITY_DISABLED
 	};
 
-	TIMER_ConfigType timer1_config =
-	{
-			.timer_id = TIMER1_ID,
-			.timer_mode = COMPARE_MODE,
-			.timer_mode_data.ctc_compare_value = TIMER1_COMPARE_VALUE_7SEC,
-			.timer_prescaler.timer1 = TIMER1_F_CPU_1024,
-			.timer_ocx_pin_behavior = DISCONNECT_OCX,
-	};
-
-	TIMER_setCallBackFunc(TIMER1_ID, APP_timerTickIncrement);	/*set timer1 call back function*/
-
 	sei(); 		/*enable global interrupt bit (I-bit)*/
 
 	/*Peripherals & Modules Initialization*/
+	SYSTICK_init();		/*1 ms tick on timer2*/
+	PROF_init();		/*free-running timer1 for the probes (only when profiling is enabled)*/
+	WDG_init();			/*watchdog supervised from the tick*/
 	USART_init(&uart_config);
 	LCD_init();
+	LCD_progressBarInit();	/*custom characters of the door position bar*/
+	KEYPAD_init();		/*keypad scanned from the tick*/
+	KEYPAD_setChord(ADMIN_CHORD_ID, ADMIN_CHORD);
+
+#if (PROF_ENABLED == 1)
+	APP_lcdBenchmark();	/*screen update timing, sent through the USART*/
+#endif
 
 	/*Display welcome message at program start.*/
 	APP_welcomeScreen();
-	/*Set a new password at the beginning of the program*/
-	APP_setNewPassword();
+	/*Bring CONTROL ECU to the start of the protocol (it may be waiting inside an exchange
+	 * since before this reset) and set a new password at the beginning of the program*/
+	do
+	{
+		APP_syncWithControl(LINK_SYNC_BOOT_BYTE);
+		APP_setNewPassword();
+	}
+	while(APP_isLinkLost());
 
 	while(1)
 	{
+		WDG_checkIn(WDG_TASK_MAIN);
+
 		/*Get user choice*/
 		choice = APP_mainMenu();
 
 		switch (choice)
 		{
 		case DOOR_OPEN:
-			APP_doorOpenSequence(&timer1_config);
+			APP_doorOpenSequence();
 			break;
 		case CHANGE_PASS:
 			APP_changePasswordSequence();
 			break;
 		case ALARM :
-			APP_alarmSequence(&timer1_config);
+			APP_alarmSequence();
+			break;
+#if (PROF_ENABLED == 1)
+		case PROFILE_REPORT:
+			APP_profileReportSequence();
 			break;
+#endif
 		default:
 			;	/*do nothing*/
 		}
+
+		/*CONTROL ECU stopped answering during the exchange*/
+		if(APP_isLinkLost())
+		{
+			APP_syncWithControl(LINK_SYNC_RESUME_BYTE);
+		}
 	}
 }